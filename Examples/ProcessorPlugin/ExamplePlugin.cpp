@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    ExamplePlugin.cpp
+    Created: 17 Oct 2026 11:02:17pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+/*
+    A minimal processor built as a shared library against ProcessorPluginApi.h, to be loaded by PluginProcessorHarness. It's a one
+    pole low pass filter followed by a gain, and depends on nothing but the API header, so it builds on its own, e.g.
+
+        Linux:      c++ -std=c++17 -O2 -shared -fPIC -fvisibility=hidden -I../../Source/Processing ExamplePlugin.cpp -o libExamplePlugin.so
+        macOS:      clang++ -std=c++17 -O2 -dynamiclib -fvisibility=hidden -I../../Source/Processing ExamplePlugin.cpp -o libExamplePlugin.dylib
+        Windows:    cl /std:c++17 /O2 /LD /I..\..\Source\Processing ExamplePlugin.cpp /Fe:ExamplePlugin.dll
+
+    To load it, set ProcessorLibraryA or ProcessorLibraryB in the DSP Testbench settings file to the path of the built library (absolute,
+    or relative to the folder of the settings file) and restart the testbench. After that, rebuilding the library is enough - the testbench reloads it as soon as the file changes.
+*/
+
+#include "ProcessorPluginApi.h"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    class ExampleProcessor
+    {
+    public:
+        explicit ExampleProcessor (const DsptbHost* hostToUse)
+            : host (*hostToUse)
+        { }
+
+        void prepare (const DsptbProcessSpec& spec)
+        {
+            sampleRate = spec.sampleRate;
+            state.assign (spec.numChannels, 0.0f);
+        }
+
+        void process (const DsptbProcessBlock& block)
+        {
+            // Only recalculate the coefficient when the frequency control has changed (and tell the host, so it can count them)
+            if (block.controlsChanged[0] != 0)
+            {
+                // Logarithmically map the 0..1 range of the control to 10Hz..20kHz
+                const auto frequency = std::pow (10.0, block.controlValues[0] * 3.30103 + 1.0);
+                coefficient = static_cast<float> (1.0 - std::exp (-2.0 * pi * frequency / sampleRate));
+                host.countRecalculation (host.context);
+            }
+            const auto gain = static_cast<float> (block.controlValues[1] * 2.0);
+
+            const auto numChannels = block.numChannels < state.size() ? block.numChannels : static_cast<uint32_t> (state.size());
+            for (uint32_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = block.channels[ch];
+                auto z = state[ch];
+                for (uint32_t i = 0; i < block.numSamples; ++i)
+                {
+                    z += coefficient * (data[i] - z);
+                    data[i] = z * gain;
+                }
+                state[ch] = z;
+            }
+        }
+
+        void reset()
+        {
+            for (auto& z : state)
+                z = 0.0f;
+        }
+
+    private:
+        static constexpr double pi = 3.14159265358979323846;
+
+        DsptbHost host;
+        double sampleRate = 44100.0;
+        float coefficient = 1.0f;
+        std::vector<float> state;
+    };
+
+    const char* getControlName (int32_t index)
+    {
+        switch (index)
+        {
+            case 0: return "Frequency";
+            case 1: return "Gain";
+            default: return "";
+        }
+    }
+
+    double getDefaultControlValue (int32_t index)
+    {
+        switch (index)
+        {
+            case 0: return 1.0;
+            case 1: return 0.5;
+            default: return 0.0;
+        }
+    }
+
+    void* create (const DsptbHost* host)                                { return new ExampleProcessor (host); }
+    void destroy (void* instance)                                       { delete static_cast<ExampleProcessor*> (instance); }
+    void prepare (void* instance, const DsptbProcessSpec* spec)         { static_cast<ExampleProcessor*> (instance)->prepare (*spec); }
+    void process (void* instance, const DsptbProcessBlock* block)       { static_cast<ExampleProcessor*> (instance)->process (*block); }
+    void reset (void* instance)                                         { static_cast<ExampleProcessor*> (instance)->reset(); }
+
+    const DsptbProcessorDescriptor descriptor = { DSPTB_PLUGIN_API_VERSION, "Example plugin (one pole LPF)", 2, getControlName,
+                                                  getDefaultControlValue, create, destroy, prepare, process, reset };
+}
+
+DSPTB_PLUGIN_EXPORT const DsptbProcessorDescriptor* dsptbGetProcessorDescriptor (void)
+{
+    return &descriptor;
+}
@@ -70,13 +70,26 @@ AnalyserComponent::AnalyserComponent()
     oscilloscope.setXMax (config->getIntAttribute ("ScopeXMax", oscilloscope.getDefaultXMaximum()));
     oscilloscope.setMaxAmplitude (static_cast<float> (config->getDoubleAttribute("ScopeMaxAmplitude", 1.0)));
     oscilloscope.setAggregationMethod (static_cast<const Oscilloscope::AggregationMethod> (config->getIntAttribute ("ScopeAggregationMethod", static_cast<int> (Oscilloscope::AggregationMethod::NearestSample))));
+    audioScopeProcessor.setTriggerMode (static_cast<AudioScopeProcessor::TriggerMode> (config->getIntAttribute ("ScopeTriggerMode", static_cast<int> (AudioScopeProcessor::TriggerMode::FreeRunning))));
+    audioScopeProcessor.setTriggerLevel (static_cast<float> (config->getDoubleAttribute ("ScopeTriggerLevel", 0.0)));
+    audioScopeProcessor.setTriggerHysteresis (static_cast<float> (config->getDoubleAttribute ("ScopeTriggerHysteresis", 0.01)));
+    audioScopeProcessor.setTriggerHoldoffMs (config->getDoubleAttribute ("ScopeTriggerHoldoff", 0.0));
+    audioScopeProcessor.setPreTriggerProportion (static_cast<float> (config->getDoubleAttribute ("ScopePreTrigger", 0.1)));
+
+    oscilloscope.setCaptureLengthSeconds (config->getDoubleAttribute ("ScopeCaptureLength", 0.0));
 
     addAndMakeVisible (goniometer);
     goniometer.assignAudioScopeProcessor (&audioScopeProcessor);
 
     addAndMakeVisible (mainMeterBackground);
-    
+    addAndMakeVisible (meterBridge);
+    meterBridge.assignProcessors (&peakMeterProcessor, &vuMeterProcessor, &clipCounterProcessor);
+    meterBridge.setRange (mainMeterBackground.getScaleMin(), mainMeterBackground.getScaleMax());
+    meterBridge.setBarBackgroundColour (Colours::transparentBlack);
+    meterBridge.onClipIndicatorClicked = [this] { showClipStats(); };
+
     clipStatsComponent.assignProcessor (&clipCounterProcessor);
+    clipStatsComponent.assignTruePeakProcessor (&truePeakMeterProcessor);
     clipStatsViewport.setViewedComponent (&clipStatsComponent, false);
     clipStatsViewport.setScrollBarsShown (false, true);
 
@@ -97,6 +110,12 @@ AnalyserComponent::~AnalyserComponent()
     config->setAttribute ("ScopeXMax", oscilloscope.getXMax());
     config->setAttribute ("ScopeMaxAmplitude", oscilloscope.getMaxAmplitude());
     config->setAttribute ("ScopeAggregationMethod", oscilloscope.getAggregationMethod());
+    config->setAttribute ("ScopeCaptureLength", oscilloscope.getCaptureLengthSeconds());
+    config->setAttribute ("ScopeTriggerMode", static_cast<int> (audioScopeProcessor.getTriggerMode()));
+    config->setAttribute ("ScopeTriggerLevel", audioScopeProcessor.getTriggerLevel());
+    config->setAttribute ("ScopeTriggerHysteresis", audioScopeProcessor.getTriggerHysteresis());
+    config->setAttribute ("ScopeTriggerHoldoff", audioScopeProcessor.getTriggerHoldoffMs());
+    config->setAttribute ("ScopePreTrigger", audioScopeProcessor.getPreTriggerProportion());
 
     // Save configuration to application properties
     auto* propertiesFile = DSPTestbenchApplication::getApp().appProperties.getUserSettings();
@@ -147,38 +166,31 @@ void AnalyserComponent::resized()
     // Force a resize of meters so positions of related components need to be updated even if the actual meter background didn't change size.
     mainMeterBackground.resized();
 
-    // Set bounds of meter bars & clip indicators
-    for (auto ch = 0; ch < numChannels; ++ch)
+    // Set bounds of meter bars & clip indicators (relative to the meter bridge, which lies over the meter background)
+    meterBridge.setBounds (mainMeterBackground.getBounds());
+    const auto offset = -meterBridge.getPosition();
+    for (auto ch = 0; ch < meterBridge.getNumChannels(); ++ch)
     {
-        if (peakMeterBars[ch] != nullptr)
-            peakMeterBars[ch]->setBounds (mainMeterBackground.getMeterBarBoundsInParent (ch, true));
-
-        if (vuMeterBars[ch] != nullptr)
-            vuMeterBars[ch]->setBounds (mainMeterBackground.getMeterBarBoundsInParent (ch, false));
-
-        if (clipIndicators[ch] != nullptr)
-            clipIndicators[ch]->setBounds (mainMeterBackground.getClipIndicatorBoundsInParent (ch));
+        meterBridge.setChannelBounds (ch, {
+            mainMeterBackground.getMeterBarBoundsInParent (ch, true) + offset,
+            mainMeterBackground.getMeterBarBoundsInParent (ch, false) + offset,
+            mainMeterBackground.getClipIndicatorBoundsInParent (ch) + offset
+        });
     }
 }
 void AnalyserComponent::timerCallback()
 {
-    for (auto ch = 0; ch < numChannels; ++ch)
-    {
-        if (peakMeterBars[ch])
-            peakMeterBars[ch]->setLevel (peakMeterProcessor.getLevelDb (ch));
-
-        if (vuMeterBars[ch])
-            vuMeterBars[ch]->setLevel (vuMeterProcessor.getLevelDb (ch));
-
-        if (clipIndicators[ch] != nullptr)
-            clipIndicators[ch]->repaint();
-    }
+    meterBridge.refresh();
     clipStatsComponent.updateStats();
 }
 void AnalyserComponent::prepare (const dsp::ProcessSpec& spec)
 {
     if (spec.numChannels > 0)
     {
+        // The scopes read from these processors on the render thread, so stop rendering until they have been prepared
+        fftScope.stopRendering();
+        oscilloscope.stopRendering();
+        goniometer.stopRendering();
         fftProcessor.prepare (spec);
         fftScope.prepare (spec);
         audioScopeProcessor.prepare (spec);
@@ -187,30 +199,12 @@ void AnalyserComponent::prepare (const dsp::ProcessSpec& spec)
         peakMeterProcessor.prepare (spec);
         vuMeterProcessor.prepare (spec);
         clipCounterProcessor.prepare (spec);
-        // If number of channels has changed, then re-initialise the meter bar components
+        truePeakMeterProcessor.prepare (spec);
+        // If number of channels has changed, then re-initialise the meters
         if (static_cast<int> (spec.numChannels) != numChannels)
         {
             numChannels = static_cast<int> (spec.numChannels);
-            peakMeterBars.clear();
-            vuMeterBars.clear();
-            clipIndicators.clear();
-            for (auto ch = 0; ch < numChannels; ++ch)
-            {
-                // Add VU meters
-                addAndMakeVisible (vuMeterBars.add (new MeterBar()));
-                vuMeterBars[ch]->setMaxDb(mainMeterBackground.getScaleMax());
-                vuMeterBars[ch]->setMinDb(mainMeterBackground.getScaleMin());
-                vuMeterBars[ch]->setBackgroundColour (Colours::transparentBlack);
-
-                // Add peak meters
-                addAndMakeVisible (peakMeterBars.add (new MeterBar()));
-                peakMeterBars[ch]->setMaxDb(mainMeterBackground.getScaleMax());
-                peakMeterBars[ch]->setMinDb(mainMeterBackground.getScaleMin());
-                peakMeterBars[ch]->setBackgroundColour (Colours::transparentBlack);
-
-                // Add clip indicators
-                addAndMakeVisible (clipIndicators.add (new ClipIndicatorComponent (ch, &clipCounterProcessor)));
-            }
+            meterBridge.setNumChannels (numChannels);
             mainMeterBackground.setNumChannels (numChannels);
             clipStatsComponent.setNumChannels (numChannels);
             resized();
@@ -218,30 +212,25 @@ void AnalyserComponent::prepare (const dsp::ProcessSpec& spec)
     }
     else
     {
-        peakMeterBars.clear();
-        vuMeterBars.clear();
+        meterBridge.setNumChannels (0);
         numChannels = 0;
         resized();
     }
 }
 void AnalyserComponent::process (const dsp::ProcessContextReplacing<float>& context)
 {
-    auto* inputBlock = &context.getInputBlock();
-    for (size_t ch = 0; ch < inputBlock->getNumChannels(); ++ch)
-    {
-        const auto chNum = static_cast<int> (ch);
-        const auto numSamples = static_cast<int> (inputBlock->getNumSamples());
-        const auto* audioData = inputBlock->getChannelPointer (ch);
-        fftProcessor.appendData (chNum, numSamples, audioData);
-        audioScopeProcessor.appendData (chNum, numSamples, audioData);
-    }
+    const auto& inputBlock = context.getInputBlock();
+    fftProcessor.appendData (inputBlock);
+    audioScopeProcessor.appendData (inputBlock);
     peakMeterProcessor.process (context);
     vuMeterProcessor.process (context);
     clipCounterProcessor.process (context);
+    truePeakMeterProcessor.process (context);
 }
 void AnalyserComponent::reset()
 {
     clipCounterProcessor.reset();
+    truePeakMeterProcessor.reset();
 }
 bool AnalyserComponent::isProcessing() const noexcept
 {
@@ -302,6 +291,7 @@ AnalyserComponent::AnalyserConfigComponent::AnalyserConfigComponent (AnalyserCom
 {
     auto* fftScopePtr = &analyserComponent->fftScope;
     auto* osc = &analyserComponent->oscilloscope;
+    auto* scopeProcessor = &analyserComponent->audioScopeProcessor;
 
     lblFftAggregation.setText("FFT scope aggregation method", dontSendNotification);
     lblFftAggregation.setJustificationType (Justification::centredRight);
@@ -349,9 +339,95 @@ AnalyserComponent::AnalyserConfigComponent::AnalyserConfigComponent (AnalyserCom
         osc->setAggregationMethod (static_cast<const Oscilloscope::AggregationMethod>(cmbScopeAggregation.getSelectedId()));
     };
 
+    lblScopeCapture.setText ("Oscilloscope capture length", dontSendNotification);
+    lblScopeCapture.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (lblScopeCapture);
+
+    // Item IDs are the capture length in seconds plus one (so that a single frame has an ID of 1)
+    cmbScopeCapture.setTooltip ("Sets how much signal history the oscilloscope displays. A single frame shows the latest 4096 samples (and can be triggered). Longer captures scroll continuously and can be zoomed all the way out, with each pixel showing the minimum and maximum of the samples it covers.");
+    cmbScopeCapture.addItem ("Single frame", 1);
+    cmbScopeCapture.addItem ("1 second", 2);
+    cmbScopeCapture.addItem ("5 seconds", 6);
+    cmbScopeCapture.addItem ("20 seconds", 21);
+    cmbScopeCapture.addItem ("60 seconds", 61);
+    addAndMakeVisible (cmbScopeCapture);
+    cmbScopeCapture.setSelectedId (roundToInt (osc->getCaptureLengthSeconds()) + 1, dontSendNotification);
+    cmbScopeCapture.onChange = [this, osc]
+    {
+        osc->setCaptureLengthSeconds (static_cast<double> (cmbScopeCapture.getSelectedId() - 1));
+    };
+
+    lblScopeTrigger.setText ("Oscilloscope trigger", dontSendNotification);
+    lblScopeTrigger.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (lblScopeTrigger);
+
+    cmbScopeTrigger.setTooltip ("Aligns the oscilloscope display to a rising or falling edge on the first channel so that periodic signals are displayed as a stable waveform. If no trigger is found for a while, the display runs free.");
+    cmbScopeTrigger.addItem ("Free running", static_cast<int> (AudioScopeProcessor::TriggerMode::FreeRunning));
+    cmbScopeTrigger.addItem ("Rising edge", static_cast<int> (AudioScopeProcessor::TriggerMode::RisingEdge));
+    cmbScopeTrigger.addItem ("Falling edge", static_cast<int> (AudioScopeProcessor::TriggerMode::FallingEdge));
+    addAndMakeVisible (cmbScopeTrigger);
+    cmbScopeTrigger.setSelectedId (static_cast<int> (scopeProcessor->getTriggerMode()), dontSendNotification);
+    cmbScopeTrigger.onChange = [this, scopeProcessor]
+    {
+        scopeProcessor->setTriggerMode (static_cast<AudioScopeProcessor::TriggerMode> (cmbScopeTrigger.getSelectedId()));
+    };
+
+    lblScopeTriggerLevel.setText ("Trigger level", dontSendNotification);
+    lblScopeTriggerLevel.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (lblScopeTriggerLevel);
+
+    sldScopeTriggerLevel.setTooltip ("Sets the trigger level as a linear amplitude");
+    sldScopeTriggerLevel.setSliderStyle (Slider::LinearHorizontal);
+    sldScopeTriggerLevel.setTextBoxStyle (Slider::TextBoxRight, false, GUI_SIZE_I(2.5), GUI_SIZE_I(0.7));
+    sldScopeTriggerLevel.setRange (-1.0, 1.0, 0.001);
+    sldScopeTriggerLevel.setValue (scopeProcessor->getTriggerLevel(), dontSendNotification);
+    sldScopeTriggerLevel.onValueChange = [this, scopeProcessor] { scopeProcessor->setTriggerLevel (static_cast<float> (sldScopeTriggerLevel.getValue())); };
+    addAndMakeVisible (sldScopeTriggerLevel);
+
+    lblScopeTriggerHysteresis.setText ("Trigger hysteresis", dontSendNotification);
+    lblScopeTriggerHysteresis.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (lblScopeTriggerHysteresis);
+
+    sldScopeTriggerHysteresis.setTooltip ("Sets how far the signal must move back past the trigger level (as a linear amplitude) before the trigger is re-armed. Increase this if noisy signals trigger erratically.");
+    sldScopeTriggerHysteresis.setSliderStyle (Slider::LinearHorizontal);
+    sldScopeTriggerHysteresis.setTextBoxStyle (Slider::TextBoxRight, false, GUI_SIZE_I(2.5), GUI_SIZE_I(0.7));
+    sldScopeTriggerHysteresis.setRange (0.0, 0.5, 0.001);
+    sldScopeTriggerHysteresis.setSkewFactorFromMidPoint (0.05);
+    sldScopeTriggerHysteresis.setValue (scopeProcessor->getTriggerHysteresis(), dontSendNotification);
+    sldScopeTriggerHysteresis.onValueChange = [this, scopeProcessor] { scopeProcessor->setTriggerHysteresis (static_cast<float> (sldScopeTriggerHysteresis.getValue())); };
+    addAndMakeVisible (sldScopeTriggerHysteresis);
+
+    lblScopeTriggerHoldoff.setText ("Trigger holdoff", dontSendNotification);
+    lblScopeTriggerHoldoff.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (lblScopeTriggerHoldoff);
+
+    sldScopeTriggerHoldoff.setTooltip ("Sets the minimum time between trigger points");
+    sldScopeTriggerHoldoff.setSliderStyle (Slider::LinearHorizontal);
+    sldScopeTriggerHoldoff.setTextBoxStyle (Slider::TextBoxRight, false, GUI_SIZE_I(2.5), GUI_SIZE_I(0.7));
+    sldScopeTriggerHoldoff.setRange (0.0, 1000.0, 0.1);
+    sldScopeTriggerHoldoff.setSkewFactorFromMidPoint (50.0);
+    sldScopeTriggerHoldoff.setTextValueSuffix (" ms");
+    sldScopeTriggerHoldoff.setValue (scopeProcessor->getTriggerHoldoffMs(), dontSendNotification);
+    sldScopeTriggerHoldoff.onValueChange = [this, scopeProcessor] { scopeProcessor->setTriggerHoldoffMs (sldScopeTriggerHoldoff.getValue()); };
+    addAndMakeVisible (sldScopeTriggerHoldoff);
+
+    lblScopePreTrigger.setText ("Pre-trigger", dontSendNotification);
+    lblScopePreTrigger.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (lblScopePreTrigger);
+
+    sldScopePreTrigger.setTooltip ("Sets the proportion of the captured frame which precedes the trigger point");
+    sldScopePreTrigger.setSliderStyle (Slider::LinearHorizontal);
+    sldScopePreTrigger.setTextBoxStyle (Slider::TextBoxRight, false, GUI_SIZE_I(2.5), GUI_SIZE_I(0.7));
+    sldScopePreTrigger.setRange (0.0, 100.0, 1.0);
+    sldScopePreTrigger.setTextValueSuffix (" %");
+    sldScopePreTrigger.setValue (scopeProcessor->getPreTriggerProportion() * 100.0, dontSendNotification);
+    sldScopePreTrigger.onValueChange = [this, scopeProcessor] { scopeProcessor->setPreTriggerProportion (static_cast<float> (sldScopePreTrigger.getValue() * 0.01)); };
+    addAndMakeVisible (sldScopePreTrigger);
+
     const String helpText = "You can pan the waveform in the oscilloscope by dragging it to the left or right. "
         "You can zoom in on the time axis with the mouse wheel. If you hold down the shift key, you can zoom "
-        "the amplitude axis. You can reset the default zoom by double-clicking.";
+        "the amplitude axis. You can reset the default zoom by double-clicking. Choose a longer capture length to scroll through "
+        "several seconds of signal.";
     txtHelp.setText(helpText, false);
     txtHelp.setMultiLine (true);
     txtHelp.setReadOnly (true);
@@ -362,7 +438,7 @@ AnalyserComponent::AnalyserConfigComponent::AnalyserConfigComponent (AnalyserCom
     txtHelp.setColour (TextEditor::ColourIds::outlineColourId, Colours::transparentBlack);
     addAndMakeVisible (txtHelp);
 
-    setSize (800, 300);
+    setSize (800, 520);
 }
 void AnalyserComponent::AnalyserConfigComponent::resized ()
 {
@@ -377,6 +453,12 @@ void AnalyserComponent::AnalyserConfigComponent::resized ()
         Track(GUI_BASE_SIZE_PX),
         Track(GUI_BASE_SIZE_PX),
         Track(GUI_BASE_SIZE_PX),
+        Track(GUI_BASE_SIZE_PX),
+        Track(GUI_BASE_SIZE_PX),
+        Track(GUI_BASE_SIZE_PX),
+        Track(GUI_BASE_SIZE_PX),
+        Track(GUI_BASE_SIZE_PX),
+        Track(GUI_BASE_SIZE_PX),
         Track(1_fr)
     };
 
@@ -390,6 +472,12 @@ void AnalyserComponent::AnalyserConfigComponent::resized ()
         GridItem(lblFftAggregation), GridItem(cmbFftAggregation),
         GridItem(lblFftRelease), GridItem(cmbFftRelease),
         GridItem(lblScopeAggregation), GridItem(cmbScopeAggregation),
+        GridItem(lblScopeCapture), GridItem(cmbScopeCapture),
+        GridItem(lblScopeTrigger), GridItem(cmbScopeTrigger),
+        GridItem(lblScopeTriggerLevel), GridItem(sldScopeTriggerLevel),
+        GridItem(lblScopeTriggerHysteresis), GridItem(sldScopeTriggerHysteresis),
+        GridItem(lblScopeTriggerHoldoff), GridItem(sldScopeTriggerHoldoff),
+        GridItem(lblScopePreTrigger), GridItem(sldScopePreTrigger),
     });
 
     grid.performLayout(getLocalBounds().reduced(GUI_GAP_I(2), GUI_GAP_I(2)));
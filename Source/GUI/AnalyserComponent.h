@@ -62,6 +62,18 @@ private:
         ComboBox cmbFftRelease;
         Label lblScopeAggregation;
         ComboBox cmbScopeAggregation;
+        Label lblScopeCapture;
+        ComboBox cmbScopeCapture;
+        Label lblScopeTrigger;
+        ComboBox cmbScopeTrigger;
+        Label lblScopeTriggerLevel;
+        Slider sldScopeTriggerLevel;
+        Label lblScopeTriggerHysteresis;
+        Slider sldScopeTriggerHysteresis;
+        Label lblScopeTriggerHoldoff;
+        Slider sldScopeTriggerHoldoff;
+        Label lblScopePreTrigger;
+        Slider sldScopePreTrigger;
         TextEditor txtHelp;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalyserConfigComponent);
@@ -86,11 +98,9 @@ private:
     PeakMeterProcessor peakMeterProcessor{};
     VUMeterProcessor vuMeterProcessor{};
     MainMeterBackground mainMeterBackground{};
-    OwnedArray<MeterBar> peakMeterBars{};
-    OwnedArray<MeterBar> vuMeterBars{};
-    OwnedArray<ClipIndicatorComponent> clipIndicators{};
-
     ClipCounterProcessor clipCounterProcessor{};
+    MeterBridge meterBridge{};
+    TruePeakMeterProcessor truePeakMeterProcessor{};
     ClipStatsComponent clipStatsComponent{};
     Viewport clipStatsViewport{};
     std::unique_ptr<DialogWindow> clipStatsWindow{};
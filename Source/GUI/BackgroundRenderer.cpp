@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    BackgroundRenderer.cpp
+    Created: 17 Oct 2026 2:05:44pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#include "BackgroundRenderer.h"
+
+BackgroundRenderer::RenderThread::RenderThread()
+    : TimeSliceThread ("Analyser Render Thread")
+{
+    startThread();
+}
+BackgroundRenderer::RenderThread::~RenderThread()
+{
+    stopThread (1000);
+}
+
+BackgroundRenderer::BackgroundRenderer (Component& componentToRepaint)
+    : targetComponent (componentToRepaint)
+{
+}
+BackgroundRenderer::~BackgroundRenderer()
+{
+    stop();
+}
+void BackgroundRenderer::start (RenderCallback&& callback)
+{
+    stop();
+    renderCallback = std::move (callback);
+    renderThread->addTimeSliceClient (this);
+    isRunning = true;
+}
+void BackgroundRenderer::stop()
+{
+    if (isRunning)
+    {
+        // This waits for the client to finish if it is currently rendering
+        renderThread->removeTimeSliceClient (this);
+        isRunning = false;
+    }
+    cancelPendingUpdate();
+}
+void BackgroundRenderer::setSize (const int width, const int height)
+{
+    imageWidth.store (width);
+    imageHeight.store (height);
+    requestRender();
+}
+void BackgroundRenderer::requestRender() noexcept
+{
+    renderRequested.store (true);
+}
+void BackgroundRenderer::drawImage (Graphics& g)
+{
+    // Render at the physical resolution of the display we're being painted on
+    scaleFactor.store (g.getInternalContext().getPhysicalPixelScaleFactor());
+
+    const ScopedLock sl (imageLock);
+    if (frontImage.isValid())
+        g.drawImage (frontImage, Rectangle<int> (imageWidth.load(), imageHeight.load()).toFloat());
+}
+int BackgroundRenderer::useTimeSlice()
+{
+    if (! renderRequested.exchange (false))
+        return idleIntervalMs;
+
+    const auto width = imageWidth.load();
+    const auto height = imageHeight.load();
+    const auto scale = scaleFactor.load();
+    const auto physicalWidth = roundToInt (static_cast<float> (width) * scale);
+    const auto physicalHeight = roundToInt (static_cast<float> (height) * scale);
+    if (physicalWidth <= 0 || physicalHeight <= 0 || ! renderCallback)
+        return idleIntervalMs;
+
+    // Only the worker touches the back image, so it can be rendered without holding the image lock
+    if (backImage.getWidth() != physicalWidth || backImage.getHeight() != physicalHeight)
+        backImage = Image (Image::ARGB, physicalWidth, physicalHeight, true, SoftwareImageType());
+    else
+        backImage.clear (backImage.getBounds());
+
+    bool rendered;
+    {
+        Graphics g (backImage);
+        g.addTransform (AffineTransform::scale (scale));
+        rendered = renderCallback (g);
+    }
+
+    if (rendered)
+    {
+        {
+            const ScopedLock sl (imageLock);
+            std::swap (frontImage, backImage);
+        }
+        triggerAsyncUpdate();
+    }
+    return idleIntervalMs;
+}
+void BackgroundRenderer::handleAsyncUpdate()
+{
+    targetComponent.repaint();
+}
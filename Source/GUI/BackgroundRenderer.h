@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    BackgroundRenderer.h
+    Created: 17 Oct 2026 2:05:44pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+/**
+*   Renders a view into an image on a shared worker thread so that the component displaying it only has to draw the latest finished
+*   image in its paint() method. This keeps the message thread responsive however expensive the view is to render (e.g. many
+*   channels or a large window).
+*
+*   Two images are used: the worker renders into the back image and then swaps it with the front image, so paint() never waits for a
+*   render in progress and never sees a partially rendered image. Once a new image is ready, the target component is repainted.
+*
+*   The render callback runs on the worker thread, so it must protect any view state it shares with the message thread.
+*/
+class BackgroundRenderer final : private TimeSliceClient, private AsyncUpdater
+{
+public:
+
+    /** Renders the view into a context sized in logical pixels (i.e. the size passed to setSize()). Return false if there was
+     *  nothing to render, in which case the current image is kept. */
+    using RenderCallback = std::function<bool (Graphics&)>;
+
+    /** The target component is repainted whenever a new image is ready. */
+    explicit BackgroundRenderer (Component& componentToRepaint);
+    ~BackgroundRenderer() override;
+
+    /** Sets the render callback and starts rendering on the worker thread. */
+    void start (RenderCallback&& callback);
+
+    /** Stops rendering and waits for any render in progress to finish. Owners should call this at the start of their destructor so
+     *  that the callback can't run while they are being destroyed. */
+    void stop();
+
+    /** Sets the size of the rendered image in logical pixels. Call this on the message thread (e.g. in resized()). */
+    void setSize (const int width, const int height);
+
+    /** Asks for the view to be rendered. This can be called from any thread, and several requests made before the worker gets
+     *  round to rendering are coalesced. */
+    void requestRender() noexcept;
+
+    /** Draws the latest rendered image at the origin. Call this on the message thread (i.e. in paint()). */
+    void drawImage (Graphics& g);
+
+private:
+
+    int useTimeSlice() override;
+    void handleAsyncUpdate() override;
+
+    /** One worker thread is shared by all renderers. */
+    class RenderThread final : public TimeSliceThread
+    {
+    public:
+        RenderThread();
+        ~RenderThread() override;
+    };
+
+    static constexpr int idleIntervalMs = 5;
+
+    Component& targetComponent;
+    SharedResourcePointer<RenderThread> renderThread;
+    RenderCallback renderCallback;
+    bool isRunning = false;
+
+    CriticalSection imageLock;
+    Image frontImage, backImage;
+    std::atomic<int> imageWidth { 0 };
+    std::atomic<int> imageHeight { 0 };
+    std::atomic<float> scaleFactor { 1.0f };
+    std::atomic<bool> renderRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BackgroundRenderer)
+};
@@ -10,17 +10,22 @@
 
 #include "BenchmarkComponent.h"
 #include "../Main.h"
+#include "../Processing/BiquadCascade.h"
 
 BenchmarkComponent::BenchmarkComponent (ProcessorHarness* processorHarnessA,
                                         ProcessorHarness* processorHarnessB,
-                                        SourceComponent* sourceComponent)
+                                        SignalRenderer signalRenderer)
     : spec (),
-      benchmarkThread (&harnesses, sourceComponent, this)
+      benchmarkThread (&harnesses, std::move (signalRenderer), this)
 {
-    harnesses.emplace_back (processorHarnessA);
-    harnesses.emplace_back (processorHarnessB);
-    if (processorHarnessA) processorHarnessA->resetStatistics();
-    if (processorHarnessB) processorHarnessB->resetStatistics();
+    liveHarnesses.emplace_back (processorHarnessA);
+    liveHarnesses.emplace_back (processorHarnessB);
+    for (auto* live : liveHarnesses)
+    {
+        instances.push_back (live ? live->createInstance() : nullptr);
+        harnesses.emplace_back (instances.back().get());
+    }
+    copyLiveControls();
 
     // Read configuration from application properties
     auto* propertiesFile = DSPTestbenchApplication::getApp().appProperties.getUserSettings();
@@ -34,6 +39,10 @@ BenchmarkComponent::BenchmarkComponent (ProcessorHarness* processorHarnessA,
     for (const auto& p : processors)
     {
         auto* lblP = processorLabels.add (new Label ("", p));
+        const auto index = processorLabels.size() - 1;
+        if (liveHarnesses[static_cast<size_t> (index)] && !harnesses[static_cast<size_t> (index)])
+            lblP->setTooltip ("This processor can't be benchmarked, as it can't create another instance of itself to run alongside the live one "
+                              "(it needs to override ProcessorHarness::createInstance)");
         lblP->setFont (titleFont);
         lblP->setColour (Label::backgroundColourId, cols::benchmarkHeadingBackground());
         lblP->setColour (Label::textColourId, cols::titleFontColour());
@@ -90,7 +99,7 @@ BenchmarkComponent::BenchmarkComponent (ProcessorHarness* processorHarnessA,
     lblChannels.setText ("Channels", dontSendNotification);
     lblChannels.setJustificationType (Justification::centredRight);
     addAndMakeVisible (lblChannels);
-    for (auto i = 1; i < 6; ++i)
+    for (auto i = 1; i < 8; ++i)
     {
         const auto id = static_cast<int> (pow (2, i - 1));
         cmbChannels.addItem (String (id), id);
@@ -111,6 +120,18 @@ BenchmarkComponent::BenchmarkComponent (ProcessorHarness* processorHarnessA,
     cmbSampleRate.setSelectedId (config->getIntAttribute ("SampleRate", 44100));
     addAndMakeVisible (cmbSampleRate);
 
+    lblSignalLength.setText ("Signal length", dontSendNotification);
+    lblSignalLength.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (lblSignalLength);
+    cmbSignalLength.setTooltip ("Length of the signal rendered from source A before the tests start, which is streamed through the processors a block at a time "
+                                "(and repeated as needed) so that signal dependent code paths are exercised. The signal is rendered from the start with source A's "
+                                "current settings, without interrupting the live audio. Audio input can't be rendered ahead of time, so it gives a silent signal.");
+    for (auto seconds : { 1, 2, 5, 10 })
+        cmbSignalLength.addItem (String (seconds) + " s", seconds);
+    cmbSignalLength.onChange = [this] { benchmarkThread.setSignalLength (cmbSignalLength.getSelectedId()); };
+    cmbSignalLength.setSelectedId (config->getIntAttribute ("SignalLength", 5));
+    addAndMakeVisible (cmbSignalLength);
+
     lblCycles.setText ("Test cycles", dontSendNotification);
     lblCycles.setJustificationType (Justification::centredRight);
     addAndMakeVisible (lblCycles);
@@ -137,9 +158,15 @@ BenchmarkComponent::BenchmarkComponent (ProcessorHarness* processorHarnessA,
     btnStart.setColour (TextButton::buttonColourId, Colours::green);
     btnStart.onClick = [this]
     {
+        // The thread reads the instances, signal & settings while it runs, so they mustn't be changed until it has finished
+        if (isTestRunning())
+            return;
+
         // Start running benchmarks on a different thread
+        copyLiveControls();
         benchmarkThread.setProcessSpec (spec);
         benchmarkThread.startRealtimeThread (Thread::RealtimeOptions());
+        updateControlEnablement();
     };
     addAndMakeVisible (btnStart);
 
@@ -152,22 +179,36 @@ BenchmarkComponent::BenchmarkComponent (ProcessorHarness* processorHarnessA,
     };
     addAndMakeVisible (btnReset);
 
+    btnBiquadSweep.setButtonText ("Biquad sweep");
+    btnBiquadSweep.setTooltip ("Measure the cost per sample of the SIMD biquad cascade (float & double) against a scalar implementation, for 1 to 64 channels at the selected block size & sample rate");
+    btnBiquadSweep.onClick = [this]
+    {
+        if (isTestRunning())
+            return;
+
+        biquadSweepThread.setProcessSpec (spec);
+        biquadSweepThread.launchThread();
+        updateControlEnablement();
+    };
+    addAndMakeVisible (btnBiquadSweep);
+
     lblBufferAlignmentStatus.setJustificationType (Justification::centredRight);
     lblBufferAlignmentStatus.setColour (Label::textColourId, Colours::lightgrey);
     addAndMakeVisible (lblBufferAlignmentStatus);
 
-    setSize (690, 430);
+    setSize (690, 460);
     startTimerHz (5);
 }
 BenchmarkComponent::~BenchmarkComponent()
 {
-    auto* deviceMgr = DSPTestbenchApplication::getApp().getMainWindow().getAudioDeviceManager();
-    deviceMgr->restartLastAudioDevice();
+    benchmarkThread.stopThread (10000);
+    biquadSweepThread.stopThread (10000);
 
     // Update configuration from class state
     config->setAttribute ("BlockSize", cmbBlockSize.getSelectedId());
     config->setAttribute ("NumChannels", cmbChannels.getSelectedId());
     config->setAttribute ("SampleRate", cmbSampleRate.getSelectedId());
+    config->setAttribute ("SignalLength", cmbSignalLength.getSelectedId());
     config->setAttribute ("TestCycles", cmbCycles.getSelectedId());
     config->setAttribute ("ProcessIterations", cmbIterations.getSelectedId());
     
@@ -270,6 +311,7 @@ void BenchmarkComponent::resized()
         Track (controlRowHeight),
         Track (controlRowHeight),
         Track (controlRowHeight),
+        Track (controlRowHeight),
         Track (controlRowHeight)
     };
     controlsGrid.templateColumns = {
@@ -286,7 +328,8 @@ void BenchmarkComponent::resized()
         GridItem().withArea (1, 7, 6, 7),
         GridItem (lblBlockSize),    GridItem (cmbBlockSize),    GridItem(),     GridItem (lblCycles),       GridItem (cmbCycles),
         GridItem (lblChannels),     GridItem (cmbChannels),     GridItem(),     GridItem (lblIterations),   GridItem (cmbIterations),
-        GridItem (lblSampleRate),   GridItem (cmbSampleRate),   GridItem(),     GridItem(),                 GridItem(),
+        GridItem (lblSampleRate),   GridItem (cmbSampleRate),   GridItem(),     GridItem (lblSignalLength), GridItem (cmbSignalLength),
+        GridItem(),                 GridItem(),                 GridItem(),     GridItem(),                 GridItem (btnBiquadSweep),
         GridItem (lblBufferAlignmentStatus).withArea ({}, GridItem::Span (2)),  GridItem(), GridItem (btnStart), GridItem (btnReset)
     });
 
@@ -295,6 +338,8 @@ void BenchmarkComponent::resized()
 }
 void BenchmarkComponent::timerCallback()
 {
+    updateControlEnablement();
+
     for (auto p = 0; p < static_cast<int> (processors.size()); ++p)
     {
         if (auto* harness = harnesses[p])
@@ -325,6 +370,17 @@ void BenchmarkComponent::timerCallback()
                     valueLabels[idxLabel]->setText (txt, sendNotificationAsync);
                 }
             }
+
+            // Report how often the processor recalculated anything derived from its controls (and how often they were automated)
+            const auto numBlocks = harness->queryProcessingDurationNumSamples();
+            auto recalculationText = String ("Recalculations: ") + String (static_cast<int> (harness->queryRecalculationCount()));
+            if (numBlocks > 0.0)
+                recalculationText << " in " << static_cast<int> (numBlocks) << " processed blocks";
+            if (const auto numEvents = harness->queryAutomationEventCount(); numEvents > 0.0)
+                recalculationText << ", automation events: " << static_cast<int> (numEvents);
+            if (const auto report = harness->queryStatisticsReport(); report.isNotEmpty())
+                recalculationText << "\n" << report;
+            routineLabels[p * static_cast<int> (routines.size()) + 1]->setTooltip (recalculationText);
         }
     }
 }
@@ -337,15 +393,39 @@ int BenchmarkComponent::getValueLabelIndex (const int processorIndex, const int
     const auto offset = (processorIndex == 0) ? 0 : static_cast<int> (routines.size() * values.size());
     return ProcessorHarness::getQueryIndex (routineIndex, valueIndex) + offset;
 }
+bool BenchmarkComponent::isTestRunning() const
+{
+    return benchmarkThread.isThreadRunning() || biquadSweepThread.isThreadRunning();
+}
+void BenchmarkComponent::updateControlEnablement()
+{
+    // Only one test can run at a time, and the settings can't be changed while it does
+    const auto enabled = !isTestRunning();
+    for (auto* c : std::initializer_list<Component*> { &btnStart, &btnBiquadSweep, &cmbBlockSize, &cmbChannels, &cmbSampleRate,
+                                                       &cmbSignalLength, &cmbCycles, &cmbIterations })
+        c->setEnabled (enabled);
+}
+void BenchmarkComponent::copyLiveControls()
+{
+    for (size_t p = 0; p < harnesses.size(); ++p)
+    {
+        if (auto* harness = harnesses[p])
+        {
+            for (auto i = 0; i < harness->getNumControls(); ++i)
+            {
+                harness->setControlValue (i, liveHarnesses[p]->getControlValue (i));
+                harness->setControlAutomation (i, liveHarnesses[p]->getControlAutomation (i));
+            }
+        }
+    }
+}
 
-BenchmarkComponent::BenchmarkThread::BenchmarkThread (std::vector<ProcessorHarness*>* harnesses, SourceComponent* sourceComponent, BenchmarkComponent* benchmarkComponent)
+BenchmarkComponent::BenchmarkThread::BenchmarkThread (std::vector<ProcessorHarness*>* harnesses, SignalRenderer signalRenderer, BenchmarkComponent* benchmarkComponent)
     : ThreadWithProgressWindow ("Benchmark is running", true, true),
-      srcComponent (sourceComponent),
+      renderSignal (std::move (signalRenderer)),
       parent (benchmarkComponent)
 {
-    // Note that we use the default timeout of 10 seconds for exiting the thread. This is needed as the benchmark can cause a NaN on one of the audio channels if
-    // processing on the ordinary thread is resumed while this one is still running. This is quite unlikely if given a second to exit, so 10 seconds should be pretty safe.
-
+    // The processors being benchmarked are only ever used by this thread (they aren't the live ones), so the audio device can keep running
     processingHarnesses = harnesses;
 }
 void BenchmarkComponent::BenchmarkThread::run()
@@ -354,6 +434,7 @@ void BenchmarkComponent::BenchmarkThread::run()
     jassert (testSpec.numChannels > 0 && testSpec.maximumBlockSize > 0 && testSpec.sampleRate > 0);
 
     const dsp::ProcessContextReplacing<float> context (*audioBlock.get());
+    const auto blockSize = audioBlock->getNumSamples();
     
     // Only count non null harnesses
     auto numHarnesses = 0;
@@ -378,8 +459,15 @@ void BenchmarkComponent::BenchmarkThread::run()
                 numerator++;
                 if (threadShouldExit()) return;
                 
+                // Stream the signal through the processor from the start (the copy isn't included in the timing)
+                size_t position = 0;
                 for (auto i = 0; i < processingIterations; ++i)
                 {
+                    audioBlock->copyFrom (arena.getSubBlock (position, blockSize));
+                    position += blockSize;
+                    if (position >= arena.getNumSamples())
+                        position = 0;
+
                     p->processHarness (context);
                     numerator++;
                     if (threadShouldExit()) return;
@@ -402,6 +490,11 @@ void BenchmarkComponent::BenchmarkThread::setProcessingIterations (const int ite
 {
     processingIterations = iterations;
 }
+void BenchmarkComponent::BenchmarkThread::setSignalLength (const double seconds)
+{
+    jassert (seconds > 0.0);
+    signalSeconds = seconds;
+}
 void BenchmarkComponent::BenchmarkThread::setProcessSpec (dsp::ProcessSpec & spec)
 {
     jassert (spec.numChannels > 0 && spec.maximumBlockSize > 0 && spec.sampleRate > 0);
@@ -409,13 +502,22 @@ void BenchmarkComponent::BenchmarkThread::setProcessSpec (dsp::ProcessSpec & spe
 
     // Initialise audio block
     audioBlock = std::make_unique<dsp::AudioBlock<float>> (heapBlock, testSpec.numChannels, testSpec.maximumBlockSize);
-    parent->setBufferAlignmentStatus (getAudioBlockAlignmentStatus());
 
-    // Fill block with audio data from source component
-    jassert (srcComponent);
-    srcComponent->prepare (spec);
-    const dsp::ProcessContextReplacing<float> context (*audioBlock.get());
-    srcComponent->process (context);
+    // Allocate the arena for a whole number of blocks (at least one), within the size limit
+    const auto blockSize = static_cast<size_t> (testSpec.maximumBlockSize);
+    const auto maxBlocks = jmax (static_cast<size_t> (1), maxArenaSamples / (blockSize * testSpec.numChannels));
+    const auto numBlocks = jlimit (static_cast<size_t> (1), maxBlocks, static_cast<size_t> (signalSeconds * testSpec.sampleRate) / blockSize);
+    arena = dsp::AudioBlock<float> (arenaMemory, testSpec.numChannels, numBlocks * blockSize);
+
+    // Render the signal before any timing starts
+    jassert (renderSignal);
+    renderSignal (testSpec, arena);
+
+    // Point out if there's nothing to test with (e.g. source A is muted or set to audio input, which can't be rendered ahead of time)
+    auto status = getAudioBlockAlignmentStatus();
+    if (arena.findMinAndMax() == Range<float>())
+        status << " (the signal from source A is silent)";
+    parent->setBufferAlignmentStatus (status);
 }
 bool BenchmarkComponent::BenchmarkThread::isSseAligned (const float* data)
 {
@@ -425,10 +527,121 @@ String BenchmarkComponent::BenchmarkThread::getAudioBlockAlignmentStatus() const
 {
     auto bufIsAligned = true;
 	for (auto ch = 0; ch < static_cast<int> (audioBlock->getNumChannels()); ++ch)
-		bufIsAligned = bufIsAligned && isSseAligned (audioBlock->getChannelPointer (ch));
+		bufIsAligned = bufIsAligned && isSseAligned (audioBlock->getChannelPointer (ch)) && isSseAligned (arena.getChannelPointer (ch));
 
 	if (bufIsAligned)
 		return "AudioBlock is SSE aligned";
 	else
 		return "AudioBlock is not SSE aligned";
-}
\ No newline at end of file
+}
+
+BenchmarkComponent::BiquadSweepThread::BiquadSweepThread()
+    : ThreadWithProgressWindow ("Biquad sweep is running", true, true)
+{
+}
+void BenchmarkComponent::BiquadSweepThread::run()
+{
+    const ScopedNoDenormals noDenormals;
+    const std::vector<String> engines = { "Scalar double", "SIMD float", "SIMD double" };
+    const std::vector<int> channelCounts = { 1, 2, 4, 8, 16, 32, 64 };
+
+    results.clear();
+    results.add ("Nanoseconds per sample per channel for a " + String (numStages) + " stage cascade, block size "
+                 + String (testSpec.maximumBlockSize) + " (SIMD lanes: float " + String (BiquadCascade<float>::numLanes)
+                 + ", double " + String (BiquadCascade<double>::numLanes) + ")");
+    results.add (String());
+
+    auto heading = String ("Channels");
+    for (const auto& e : engines)
+        heading << "   |   " << e;
+    results.add (heading);
+
+    const auto numMeasurements = static_cast<double> (channelCounts.size() * engines.size());
+    auto count = 0;
+    for (const auto numChannels : channelCounts)
+    {
+        auto line = String (numChannels);
+        for (auto e = 0; e < static_cast<int> (engines.size()); ++e)
+        {
+            line << "   |   " << String (measure (e, numChannels), 2);
+            setProgress (++count / numMeasurements);
+            if (threadShouldExit())
+                return;
+        }
+        results.add (line);
+    }
+}
+void BenchmarkComponent::BiquadSweepThread::threadComplete (bool userPressedCancel)
+{
+    if (!userPressedCancel)
+        AlertWindow::showMessageBoxAsync (AlertWindow::AlertIconType::InfoIcon, "Biquad sweep", results.joinIntoString ("\n"));
+}
+void BenchmarkComponent::BiquadSweepThread::setProcessSpec (const dsp::ProcessSpec& spec)
+{
+    jassert (spec.maximumBlockSize > 0 && spec.sampleRate > 0);
+    testSpec = spec;
+}
+double BenchmarkComponent::BiquadSweepThread::measure (const int engineIndex, const int numChannels)
+{
+    const auto blockSize = static_cast<int> (testSpec.maximumBlockSize);
+    const auto numBlocks = jmax (16, (1 << 21) / (blockSize * numChannels));
+
+    // Fill the buffer with noise, which is filtered in place for every block (the filter is stable so the level is bounded)
+    AudioBuffer<float> buffer (numChannels, blockSize);
+    Random random;
+    for (auto ch = 0; ch < numChannels; ++ch)
+        for (auto i = 0; i < blockSize; ++i)
+            buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+    dsp::AudioBlock<float> block (buffer);
+    const dsp::ProcessContextReplacing<float> context (block);
+
+    const auto frequency = jmin (1000.0, testSpec.sampleRate * 0.25);
+    const auto coefficients = BiquadCascade<double>::Coefficients::makeLowPass (frequency, testSpec.sampleRate);
+    BiquadCascade<float> floatCascade;
+    BiquadCascade<double> doubleCascade;
+    HeapBlock<double> scalarState (static_cast<size_t> (numChannels * numStages * 2), true);
+
+    if (engineIndex == 1)
+    {
+        floatCascade.prepare (numChannels, numStages, blockSize);
+        floatCascade.setCoefficients ({ static_cast<float> (coefficients.b0), static_cast<float> (coefficients.b1), static_cast<float> (coefficients.b2),
+                                        static_cast<float> (coefficients.a1), static_cast<float> (coefficients.a2) });
+    }
+    else if (engineIndex == 2)
+    {
+        doubleCascade.prepare (numChannels, numStages, blockSize);
+        doubleCascade.setCoefficients (coefficients);
+    }
+
+    const auto start = Time::getHighResolutionTicks();
+    for (auto b = 0; b < numBlocks; ++b)
+    {
+        switch (engineIndex)
+        {
+            case 1: floatCascade.process (context); break;
+            case 2: doubleCascade.process (context); break;
+            default:
+                // Scalar reference - each channel and stage in turn, with the state held in doubles
+                for (auto ch = 0; ch < numChannels; ++ch)
+                {
+                    auto* data = buffer.getWritePointer (ch);
+                    for (auto stage = 0; stage < numStages; ++stage)
+                    {
+                        auto& s1 = scalarState[(ch * numStages + stage) * 2];
+                        auto& s2 = scalarState[(ch * numStages + stage) * 2 + 1];
+                        for (auto i = 0; i < blockSize; ++i)
+                        {
+                            const auto x = static_cast<double> (data[i]);
+                            const auto y = coefficients.b0 * x + s1;
+                            s1 = coefficients.b1 * x - coefficients.a1 * y + s2;
+                            s2 = coefficients.b2 * x - coefficients.a2 * y;
+                            data[i] = static_cast<float> (y);
+                        }
+                    }
+                }
+                break;
+        }
+    }
+    const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+    return seconds * 1.0E9 / (static_cast<double> (numBlocks) * blockSize * numChannels);
+}
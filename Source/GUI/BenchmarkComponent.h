@@ -12,14 +12,21 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "../Processing/ProcessorHarness.h"
-#include "SourceComponent.h"
 
+/**
+ * Benchmarks processors A and B without disturbing the audio device. The tests run on new instances of the processors (from
+ * ProcessorHarness::createInstance), which copy the control values and automation of the live processors when each test starts, so
+ * the measurements never race with live processing. Processors which can't create instances aren't benchmarked.
+ */
 class BenchmarkComponent : public Component, public Timer
 {
 public:
 
-    /** Pass in pointers to both process harnesses and the source component for the audio to into them. */
-    BenchmarkComponent (ProcessorHarness* processorHarnessA, ProcessorHarness* processorHarnessB, SourceComponent* sourceComponent);
+    /** Renders a signal into a block (a whole number of blocks long) at a ProcessSpec. */
+    using SignalRenderer = std::function<void (const dsp::ProcessSpec&, const dsp::AudioBlock<float>&)>;
+
+    /** Pass in pointers to both live process harnesses (to create instances of) and a function to render the audio to test with. */
+    BenchmarkComponent (ProcessorHarness* processorHarnessA, ProcessorHarness* processorHarnessB, SignalRenderer signalRenderer);
     ~BenchmarkComponent() override;
     void paint (Graphics& g) override;
     void resized() override;
@@ -31,7 +38,7 @@ private:
     class BenchmarkThread : public ThreadWithProgressWindow
     {
     public:
-        BenchmarkThread (std::vector<ProcessorHarness*>* harnesses, SourceComponent* sourceComponent, BenchmarkComponent* benchmarkComponent);
+        BenchmarkThread (std::vector<ProcessorHarness*>* harnesses, SignalRenderer signalRenderer, BenchmarkComponent* benchmarkComponent);
         ~BenchmarkThread() override = default;
 
         void run() override;
@@ -43,7 +50,10 @@ private:
         /** Set number of times to iterate the processing within each cycle. */
         void setProcessingIterations (const int iterations);
         
-        /**< Set ProcessSpec to test against. */
+        /** Set the length of the signal to stream through the processors (in seconds). */
+        void setSignalLength (const double seconds);
+
+        /**< Set ProcessSpec to test against, and render the signal. */
         void setProcessSpec (dsp::ProcessSpec& spec);
 
     private:
@@ -54,25 +64,64 @@ private:
         /** Returns a string describing the buffer alignment status. */
         String getAudioBlockAlignmentStatus() const;
 
+        /** Limit on the size of the signal arena (in samples, over all channels), which is 256 MB. */
+        static constexpr size_t maxArenaSamples = 1 << 26;
+
         std::vector<ProcessorHarness*>* processingHarnesses{};
-        SourceComponent* srcComponent;
+        SignalRenderer renderSignal;
         BenchmarkComponent* parent;
         int testCycles = 0;
         int processingIterations = 0;
         dsp::ProcessSpec testSpec {};
+        double signalSeconds = 5.0;
         HeapBlock<char> heapBlock{};
         std::unique_ptr<dsp::AudioBlock<float>> audioBlock{};
+        HeapBlock<char> arenaMemory{};
+        dsp::AudioBlock<float> arena {};        // The whole signal, a whole number of blocks long, which is copied into audioBlock a block at a time
+    };
+
+    /** Measures the cost per sample of a BiquadCascade against a scalar per-channel implementation, for 1 to 64 channels. */
+    class BiquadSweepThread : public ThreadWithProgressWindow
+    {
+    public:
+        BiquadSweepThread();
+        ~BiquadSweepThread() override = default;
+
+        void run() override;
+        void threadComplete (bool userPressedCancel) override;
+
+        /** Set ProcessSpec to test against (the number of channels is ignored). */
+        void setProcessSpec (const dsp::ProcessSpec& spec);
+
+    private:
+
+        static constexpr int numStages = 4;
+
+        /** Returns the processing time in nanoseconds per sample per channel for one of the engines. */
+        double measure (const int engineIndex, const int numChannels);
+
+        dsp::ProcessSpec testSpec {};
+        StringArray results {};
     };
 
     int getValueLabelIndex (const int processorIndex, const int routineIndex, const int valueIndex) const;
 
+    /** Returns true while the benchmark or the biquad sweep is running. */
+    bool isTestRunning() const;
+
+    /** Disables starting a test and changing the settings while a test is running. */
+    void updateControlEnablement();
+
+    /** Copies the control values and automation of the live processors to the instances being benchmarked. */
+    void copyLiveControls();
+
     OwnedArray<Label> processorLabels{};
     OwnedArray<Label> routineLabels{};
     OwnedArray<Label> valueTitleLabels{};
     OwnedArray<Label> valueLabels{};
-    Label lblChannels, lblBlockSize, lblSampleRate, lblCycles, lblIterations, lblBufferAlignmentStatus;
-    ComboBox cmbChannels, cmbBlockSize, cmbSampleRate, cmbCycles, cmbIterations;
-    TextButton btnStart, btnReset;
+    Label lblChannels, lblBlockSize, lblSampleRate, lblSignalLength, lblCycles, lblIterations, lblBufferAlignmentStatus;
+    ComboBox cmbChannels, cmbBlockSize, cmbSampleRate, cmbSignalLength, cmbCycles, cmbIterations;
+    TextButton btnStart, btnReset, btnBiquadSweep;
 
     dsp::ProcessSpec spec;
 
@@ -81,8 +130,11 @@ private:
     const std::vector<String> values = { "Min", "Avg", "Max", "#" };
     const std::vector<String> valueTooltips = { "Minimum time for routine (microseconds)", "Average time for routine (microseconds)", "Maximum time for routine (microseconds)", "Number of times this routine was run" };
 
-    std::vector<ProcessorHarness*> harnesses{};
+    std::vector<ProcessorHarness*> liveHarnesses{};
+    std::vector<std::unique_ptr<ProcessorHarness>> instances{};
+    std::vector<ProcessorHarness*> harnesses{};                     // The instances being benchmarked (or nullptr)
     BenchmarkThread benchmarkThread;
+    BiquadSweepThread biquadSweepThread;
     std::unique_ptr<XmlElement> config {};
     const String keyName = "Benchmarking";
         
@@ -12,6 +12,7 @@
 
 #include "../Processing/FftProcessor.h"
 #include "../Processing/FastApproximations.h"
+#include "BackgroundRenderer.h"
 
 template <int Order>
 class FftScope final : public Component, public Timer
@@ -48,6 +49,9 @@ public:
     // Must be called after FftProcessor:prepare() so that the AudioProbe listeners can be set up properly
     void prepare (const dsp::ProcessSpec& spec);
 
+    // Must be called before FftProcessor:prepare() because the spectrum is read on the render thread (prepare() restarts rendering)
+    void stopRendering();
+
     // Set minimum dB value for y-axis (defaults to -80dB otherwise)
     void setDbMin (const float minimumDb);
     float getDbMin() const;
@@ -98,7 +102,9 @@ private:
         FftScope* parentScope;
     };
 
+    bool renderFft (Graphics& g);
     void paintFft (Graphics& g) const;
+    void paintCursor (Graphics& g) const;
     void paintFftScale (Graphics& g) const;
 
     inline float toDbVFromLinear (const float linear) const;
@@ -115,7 +121,7 @@ private:
     Background background;
     Foreground foreground;
 	FftProcessor<Order>* fftProcessor;
-    HeapBlock<float> x, y;
+    HeapBlock<float> x;
 	double samplingFreq = 48000; // will be set correctly in prepare()
     float dbMax = 0.0f;
     float dbMin = -80.0f;
@@ -127,6 +133,8 @@ private:
     float yRatio = 1.0f;
     float xRatioInv = 1.0f;
     float yRatioInv = 1.0f;
+    int plotWidth = 0;
+    int plotHeight = 0;
     int currentX = -1;
     int currentY = -1;
     AggregationMethod aggregationMethod = AggregationMethod::Maximum;
@@ -134,6 +142,7 @@ private:
     float mediumRelease = 0.667f;
     float slowRelease = 0.9f;
     bool mouseMoveRepaintsEnabled = false;
+    CriticalSection criticalSection;
     
     ListenerRemovalCallback removeListenerCallback = {};
     typename WeakReference<FftScope<Order>>::Master masterReference;
@@ -144,6 +153,9 @@ private:
     // Candidate frequencies for drawing the grid on the background
     Array<float> gridFrequencies = { 20.0f, 50.0f, 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f, 16000.0f, 32000.0f, 64000.0f };
 
+    // Renders the spectrum on a worker thread (view state shared with the render thread is protected by criticalSection)
+    BackgroundRenderer renderer;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FftScope);
 };
 
@@ -173,14 +185,17 @@ FftScope<Order>::Foreground::Foreground (FftScope* parentFftScope)
 template <int Order>
 void FftScope<Order>::Foreground::paint (Graphics& g)
 {
-    parentScope->paintFft (g);
+    // The spectrum is rendered on the render thread, so all we need to do here is draw the latest image and the cursor
+    parentScope->renderer.drawImage (g);
+    parentScope->paintCursor (g);
 }
 
 template <int Order>
 FftScope<Order>::FftScope ()
     :   background (this),
         foreground (this),
-        fftProcessor (nullptr)
+        fftProcessor (nullptr),
+        renderer (foreground)
 {
     this->setOpaque (true);
     this->setPaintingIsUnclipped (true);
@@ -198,6 +213,8 @@ FftScope<Order>::FftScope ()
 template <int Order>
 FftScope<Order>::~FftScope ()
 {
+    // Stop rendering first so the render thread can't access anything while we're being destroyed
+    renderer.stop();
     masterReference.clear();
     // Remove listener callbacks so we don't leave anything hanging if we pop up an FftScope then remove it
     if (removeListenerCallback) removeListenerCallback();
@@ -210,9 +227,15 @@ void FftScope<Order>::paint (Graphics&)
 template <int Order>
 void FftScope<Order>::resized ()
 {
-    preCalculateVariables();
+    {
+        const ScopedLock sl (criticalSection);
+        plotWidth = getWidth();
+        plotHeight = getHeight();
+        preCalculateVariables();
+    }
     background.setBounds (getLocalBounds());
     foreground.setBounds (getLocalBounds());
+    renderer.setSize (getWidth(), getHeight());
 }
 
 template <int Order>
@@ -241,10 +264,10 @@ void FftScope<Order>::mouseExit (const MouseEvent&)
 template<int Order>
 inline void FftScope<Order>::timerCallback()
 {
-    // Only repaint if a new data frame is ready (flag is set by a listener callback from the audio thread)
+    // Only render if a new data frame is ready (flag is set by a listener callback from the audio thread)
     if (dataFrameReady.get())
     {
-        repaint();
+        renderer.requestRender();
         dataFrameReady.set (false);
     }
 }
@@ -255,14 +278,17 @@ void FftScope<Order>::assignFftProcessor (FftProcessor<Order>* fftMultPtr)
     jassert (fftMultPtr != nullptr);
     fftProcessor = fftMultPtr;
     x.allocate (fftProcessor->getMaximumBlockSize(), true);
-    y.allocate (fftProcessor->getMaximumBlockSize(), true);
 }
 
 template <int Order>
 void FftScope<Order>::prepare (const dsp::ProcessSpec& spec)
 {
-    samplingFreq = spec.sampleRate;
-    preCalculateVariables();
+    {
+        const ScopedLock sl (criticalSection);
+        samplingFreq = spec.sampleRate;
+        preCalculateVariables();
+    }
+    renderer.start ([this] (Graphics& g) { return renderFft (g); });
     WeakReference<FftScope<Order>> weakThis = this;
     removeListenerCallback = fftProcessor->addListenerCallback ([this, weakThis]
     {
@@ -272,9 +298,16 @@ void FftScope<Order>::prepare (const dsp::ProcessSpec& spec)
     });
 }
 
+template <int Order>
+void FftScope<Order>::stopRendering()
+{
+    renderer.stop();
+}
+
 template <int Order>
 void FftScope<Order>::setDbMin (const float minimumDb)
 {
+    const ScopedLock sl (criticalSection);
     dbMin = minimumDb;
 }
 
@@ -287,6 +320,7 @@ float FftScope<Order>::getDbMin () const
 template <int Order>
 void FftScope<Order>::setDbMax (const float maximumDb)
 {
+    const ScopedLock sl (criticalSection);
     dbMax = maximumDb;
 }
 
@@ -299,6 +333,7 @@ float FftScope<Order>::getDbMax () const
 template <int Order>
 void FftScope<Order>::setFreqMin (const float minimumFreq)
 {
+    const ScopedLock sl (criticalSection);
     minFreq = minimumFreq;
 }
 
@@ -311,6 +346,7 @@ float FftScope<Order>::getFreqMin () const
 template <int Order>
 void FftScope<Order>::setFreqMax (const float maximumFreq)
 {
+    const ScopedLock sl (criticalSection);
     maxFreq = maximumFreq;
 }
 
@@ -323,7 +359,9 @@ float FftScope<Order>::getFreqMax () const
 template <int Order>
 void FftScope<Order>::setAggregationMethod (const AggregationMethod method)
 {
+    const ScopedLock sl (criticalSection);
     aggregationMethod = method;
+    renderer.requestRender();
 }
 
 template<int Order>
@@ -374,6 +412,15 @@ inline void FftScope<Order>::setMouseMoveRepaintEnablement(const bool enableRepa
     mouseMoveRepaintsEnabled = enableRepaints;
 }
 
+template <int Order>
+bool FftScope<Order>::renderFft (Graphics& g)
+{
+    // Called on the render thread
+    const ScopedLock sl (criticalSection);
+    paintFft (g);
+    return true;
+}
+
 template <int Order>
 void FftScope<Order>::paintFft (Graphics& g) const
 {
@@ -385,56 +432,66 @@ void FftScope<Order>::paintFft (Graphics& g) const
 
     for (auto ch = 0; ch < fftProcessor->getNumChannels(); ++ch)
     {
-        // Copy frequency data and scale
-        fftProcessor->copyFrequencyFrame (y, ch);
-
         // Create a path representing the freq data for this channel and pre-allocate space
         Path p;
-        p.preallocateSpace ((getWidth() + 1) * 3); // Will generally be a lot less than this for log frequency scale
+        p.preallocateSpace ((plotWidth + 1) * 3); // Will generally be a lot less than this for log frequency scale
+
+        // Borrow the latest frequency frame rather than copying it (skip the channel if no consistent frame could be read)
+        const auto frameIsValid = fftProcessor->readFrequencyFrame (ch, [this, n, &p] (const float* y)
+        {
+            p.clear();
 
-        // Find first positive x value (important if minFreq is set higher than default
-        auto i = 0;
-        while (x[i] < 0)
+            // Find first positive x value (important if minFreq is set higher than default
+            auto i = 0;
+            while (x[i] < 0)
+                ++i;
+            p.startNewSubPath (x[i], toPxFromLinear (y[i]));
             ++i;
-        p.startNewSubPath (x[i], toPxFromLinear (y[i]));
-        ++i;
 
-        // Iterate through x and plot each point, but aggregate across y if x interval is less than a pixel
-        auto curX = static_cast<int> (x[i]); // x co-ordinate in pixels
-        float aggY; // aggregated y value
-        while (curX < getWidth() && i <= n)
-        {
-            const auto nextX = curX + 1; // next pixel along on x-axis
-            if (aggregationMethod == AggregationMethod::Average)
+            // Iterate through x and plot each point, but aggregate across y if x interval is less than a pixel
+            auto curX = static_cast<int> (x[i]); // x co-ordinate in pixels
+            float aggY; // aggregated y value
+            while (curX < plotWidth && i <= n)
             {
-                auto ySum = y[i];
-                auto count = 1;
-                while (i < n && x[i+1] < nextX)
+                const auto nextX = curX + 1; // next pixel along on x-axis
+                if (aggregationMethod == AggregationMethod::Average)
                 {
-                    i++;
-                    ySum += y[i];
-                    count++;
+                    auto ySum = y[i];
+                    auto count = 1;
+                    while (i < n && x[i+1] < nextX)
+                    {
+                        i++;
+                        ySum += y[i];
+                        count++;
+                    }
+                    aggY = ySum / static_cast<float> (count);
                 }
-                aggY = ySum / static_cast<float> (count);
-            }
-            else // aggregate with maximum
-            {
-                aggY = y[i];
-                while (i < n && x[i+1] < nextX)
+                else // aggregate with maximum
                 {
-                    i++;
-                    aggY = jmax (aggY, y[i]);
+                    aggY = y[i];
+                    while (i < n && x[i+1] < nextX)
+                    {
+                        i++;
+                        aggY = jmax (aggY, y[i]);
+                    }
                 }
+                p.lineTo (x[i], toPxFromLinear (aggY));
+                ++i;
+                curX = static_cast<int> (x[i]);
             }
-            p.lineTo (x[i], toPxFromLinear (aggY));
-            ++i;
-            curX = static_cast<int> (x[i]);
-        }
+        });
+        if (! frameIsValid)
+            continue;
+
         const auto pst = PathStrokeType (1.0f);
         g.setColour (getColourForChannel (ch));
         g.strokePath (p, pst);
     }
+}
 
+template <int Order>
+void FftScope<Order>::paintCursor (Graphics& g) const
+{
     // Output mouse co-ordinates in Hz/dB
     if (currentX >= 0 && currentY >= 0)
     {
@@ -620,7 +677,7 @@ void FftScope<Order>::preCalculateVariables()
     minLogFreq = log10 (minFreq);
     logFreqSpan = log10 (maxFreq) - minLogFreq;
     const auto n = fftProcessor->getMaximumBlockSize() / 2;
-    xRatio = static_cast<float> (getWidth()) / logFreqSpan;
+    xRatio = static_cast<float> (plotWidth) / logFreqSpan;
     xRatioInv = 1.0f / xRatio;
     
     const auto binToHz = nyquist / static_cast<float> (n);
@@ -628,6 +685,7 @@ void FftScope<Order>::preCalculateVariables()
         // x[] will hold the x co-ordinate (in pixels) for each bin
         x[i] = toPxFromHz (static_cast<float> (i) * binToHz);
 
-    yRatio = static_cast<float> (getHeight()) / (dbMin - dbMax);
+    yRatio = static_cast<float> (plotHeight) / (dbMin - dbMax);
     yRatioInv = 1.0f / yRatio;
+    renderer.requestRender();
 }
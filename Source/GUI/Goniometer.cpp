@@ -29,13 +29,16 @@ Goniometer::Foreground::Foreground (Goniometer* parentGoniometer)
 }
 void Goniometer::Foreground::paint (Graphics& g)
 {
-    parentScope->paintWaveform (g);
+    // The waveform is rendered on the render thread, so all we need to do here is draw the latest image and the readout
+    parentScope->renderer.drawImage (g);
+    parentScope->paintReadout (g);
 }
 
 Goniometer::Goniometer ()
     :   background (this),
         foreground (this),
-        audioScopeProcessor (nullptr)
+        audioScopeProcessor (nullptr),
+        renderer (foreground)
 {
     this->setOpaque (true);
     this->setPaintingIsUnclipped (true);
@@ -45,33 +48,58 @@ Goniometer::Goniometer ()
 
     addMouseListener (this, true);
 
+    // Map density to colour, saturating gradually so that both sparse and dense regions remain visible
+    ColourGradient gradient (Colours::transparentBlack, 0.0f, 0.0f, Colours::white, 1.0f, 0.0f, false);
+    gradient.addColour (0.15, Colours::darkgreen.withAlpha (0.6f));
+    gradient.addColour (0.6, Colours::yellow);
+    colourLut.allocate (lutSize, false);
+    for (auto i = 0; i < lutSize; ++i)
+    {
+        const auto hits = static_cast<float> (i) / densityToLutIndex;
+        colourLut[i] = gradient.getColourAtPosition (1.0 - std::exp (-0.1 * hits)).getPixelARGB();
+    }
+
     dataFrameReady.set(false);
+    frameToAccumulate.set (false);
+    densityVisible.set (false);
+    correlation.set (0.0f);
+    balanceDb.set (0.0f);
     startTimer (50);
 }
 Goniometer::~Goniometer ()
 {
+    // Stop rendering first so the render thread can't access anything while we're being destroyed
+    renderer.stop();
     masterReference.clear();
     // Remove listener callbacks so we don't leave anything hanging if we pop up an Goniometer then remove it
     if (removeListenerCallback) removeListenerCallback();
 }
 void Goniometer::paint (Graphics&)
-{
-    for (auto ch = 0; ch < audioScopeProcessor->getNumChannels(); ++ch)
-        audioScopeProcessor->copyFrame (buffer.getWritePointer(ch), ch);
-}
+{ }
 void Goniometer::resized ()
 {
+    {
+        const ScopedLock sl (criticalSection);
+        plotBounds = getPlotBounds();
+    }
     background.setBounds (getLocalBounds());
     foreground.setBounds (getLocalBounds());
+    renderer.setSize (getWidth(), getHeight());
 }
 void Goniometer::timerCallback()
 {
-    // Only repaint if a new data frame is ready (flag is set by a listener callback from the audio thread)
+    // Only render if a new data frame is ready (flag is set by a listener callback from the audio thread)
     if (dataFrameReady.get())
     {
-        repaint();
+        frameToAccumulate.set (true);
+        renderer.requestRender();
         dataFrameReady.set (false);
     }
+    // Otherwise keep the persistence decaying until nothing is left on screen
+    else if (densityVisible.get())
+    {
+        renderer.requestRender();
+    }
 }
 void Goniometer::assignAudioScopeProcessor (AudioScopeProcessor* audioScopeProcessorPtr)
 {
@@ -81,7 +109,13 @@ void Goniometer::assignAudioScopeProcessor (AudioScopeProcessor* audioScopeProce
 void Goniometer::prepare()
 {
     jassert (audioScopeProcessor != nullptr); // audioScopeProcessor should be assigned & prepared first
-    buffer.setSize (audioScopeProcessor->getNumChannels(), audioScopeProcessor->getMaximumBlockSize());
+    {
+        const ScopedLock sl (criticalSection);
+        buffer.setSize (audioScopeProcessor->getNumChannels(), audioScopeProcessor->getMaximumBlockSize());
+        xPx.allocate (static_cast<size_t> (buffer.getNumSamples()), false);
+        yPx.allocate (static_cast<size_t> (buffer.getNumSamples()), false);
+    }
+    renderer.start ([this] (Graphics& g) { return renderWaveform (g); });
     WeakReference<Goniometer> weakThis = this;
     removeListenerCallback = audioScopeProcessor->addListenerCallback ([this, weakThis]
     {
@@ -90,40 +124,151 @@ void Goniometer::prepare()
             dataFrameReady.set (true);
     });
 }
-void Goniometer::paintWaveform (Graphics& g) const
+void Goniometer::stopRendering()
 {
-    // To speed things up we make sure we stay within the graphics context so we can disable clipping at the component level
+    renderer.stop();
+}
+float Goniometer::getCorrelation() const
+{
+    return correlation.get();
+}
+float Goniometer::getBalanceDb() const
+{
+    return balanceDb.get();
+}
+bool Goniometer::renderWaveform (Graphics& g)
+{
+    // Called on the render thread
+    const ScopedLock sl (criticalSection);
 
-    if (audioScopeProcessor->getNumChannels() < 2)
-        return;
+    // (Re)allocate the density buffer if the plot size has changed
+    if (plotBounds.getWidth() != densitySize)
+    {
+        densitySize = plotBounds.getWidth();
+        density.allocate (static_cast<size_t> (densitySize * densitySize), true);
+        densityImage = densitySize > 0 ? Image (Image::ARGB, densitySize, densitySize, true, SoftwareImageType()) : Image();
+    }
+    if (densitySize <= 0)
+        return false;
+
+    // Decay the density according to the time since the last render
+    const auto now = Time::getMillisecondCounterHiRes();
+    const auto elapsedSeconds = lastRenderTime > 0.0 ? (now - lastRenderTime) * 0.001 : 0.0;
+    lastRenderTime = now;
+    const auto decay = static_cast<float> (std::exp (-elapsedSeconds / persistenceSeconds));
+    FloatVectorOperations::multiply (density, decay, densitySize * densitySize);
+
+    if (frameToAccumulate.exchange (false) && buffer.getNumChannels() >= 2)
+    {
+        // Only use first two channels (ignore extra channels)
+        if (audioScopeProcessor->copyFrame (buffer.getWritePointer (0), 0) && audioScopeProcessor->copyFrame (buffer.getWritePointer (1), 1))
+            accumulateFrame();
+    }
 
-    // Only use first two channels (ignore extra channels)
-    const auto* x = buffer.getReadPointer (0);
-    const auto* y = buffer.getReadPointer (1);
+    // Anything below one LUT step is drawn transparent, so there is no need to keep rendering once everything is below that
+    densityVisible.set (FloatVectorOperations::findMaximum (density.get(), densitySize * densitySize) * densityToLutIndex >= 1.0f);
 
-    const auto plotBoundsFloat = getPlotBounds().toFloat();
-    const auto cx = plotBoundsFloat.getCentreX() - 0.5f;
-    const auto cy = plotBoundsFloat.getCentreY() - 0.5f;
-    const auto unitRadius = plotBoundsFloat.getWidth() / 2.0f;
+    updateDensityImage();
+    paintWaveform (g);
+    return true;
+}
+void Goniometer::accumulateFrame()
+{
+    const auto* left = buffer.getReadPointer (0);
+    const auto* right = buffer.getReadPointer (1);
+    const auto numSamples = buffer.getNumSamples();
 
-    g.setColour (Colours::yellow.withMultipliedAlpha (0.5f));
+    // Rotate by 45 degrees into side (x) and mid (y) in pixels, so that mono is vertical and a single channel lies on a diagonal.
+    // This is linear, so it vectorises (the previous polar conversion needed a sqrt, atan2, cos and sin for every sample).
+    const auto halfSize = static_cast<float> (densitySize) * 0.5f;
+    const auto scale = halfSize * MathConstants<float>::sqrt2 * 0.5f; // Full scale on one channel reaches the edge of the circle
+    FloatVectorOperations::subtract (xPx, right, left, numSamples);
+    FloatVectorOperations::multiply (xPx, scale, numSamples);
+    FloatVectorOperations::add (xPx, halfSize, numSamples);
+    FloatVectorOperations::add (yPx, left, right, numSamples);
+    FloatVectorOperations::multiply (yPx, -scale, numSamples);
+    FloatVectorOperations::add (yPx, halfSize, numSamples);
 
-    // Iterate through samples
-    for (auto i = 0; i < buffer.getNumSamples(); i++)
+    // Accumulate hits (points beyond the unit circle are dropped) and measure correlation and balance in the same pass
+    const auto radiusSquared = halfSize * halfSize;
+    auto sumLL = 0.0f, sumRR = 0.0f, sumLR = 0.0f;
+    for (auto i = 0; i < numSamples; ++i)
     {
-        // Convert cartesian to polar coordinate
-        const auto amplitude = sqrt (x[i] * x[i] + y[i] * y[i]) + 1e-15f; // Anti-denormal float
-        const auto radius = amplitude * unitRadius;
+        const auto l = left[i];
+        const auto r = right[i];
+        sumLL += l * l;
+        sumRR += r * r;
+        sumLR += l * r;
+
+        const auto dx = xPx[i] - halfSize;
+        const auto dy = yPx[i] - halfSize;
+        if (dx * dx + dy * dy < radiusSquared)
+        {
+            const auto px = jlimit (0, densitySize - 1, static_cast<int> (xPx[i]));
+            const auto py = jlimit (0, densitySize - 1, static_cast<int> (yPx[i]));
+            density[py * densitySize + px] += 1.0f;
+        }
+    }
 
-        if (radius <= unitRadius) // Don't draw points beyond our bounds
+    const auto energy = std::sqrt (sumLL * sumRR);
+    correlation.set (energy > 1.0e-12f ? jlimit (-1.0f, 1.0f, sumLR / energy) : 0.0f);
+    balanceDb.set (sumLL + sumRR > 1.0e-12f ? Decibels::gainToDecibels (sumLL, 1.0e-12f) * 0.5f - Decibels::gainToDecibels (sumRR, 1.0e-12f) * 0.5f : 0.0f);
+}
+void Goniometer::updateDensityImage()
+{
+    // Map density to colour through the LUT, writing straight into the image data
+    const Image::BitmapData bitmap (densityImage, Image::BitmapData::writeOnly);
+    const auto maxIndex = static_cast<float> (lutSize - 1);
+    for (auto y = 0; y < densitySize; ++y)
+    {
+        const auto* row = density + y * densitySize;
+        auto* pixel = bitmap.getLinePointer (y);
+        for (auto x = 0; x < densitySize; ++x)
         {
-            const auto angle = std::atan2 (y[i], x[i]) + 0.78539816f; // Rotate coordinate by 45 degrees counter clockwise
-            const auto xx = cx + radius * cos (angle);
-            const auto yy = cy + radius * sin (angle);
-            g.fillRect (xx, yy, 1.0f, 1.0f);
+            const auto index = static_cast<int> (jmin (maxIndex, row[x] * densityToLutIndex));
+            *reinterpret_cast<PixelARGB*> (pixel) = colourLut[index];
+            pixel += bitmap.pixelStride;
         }
     }
 }
+void Goniometer::paintWaveform (Graphics& g) const
+{
+    // To speed things up we make sure we stay within the graphics context so we can disable clipping at the component level
+    g.drawImageAt (densityImage, plotBounds.getX(), plotBounds.getY());
+}
+void Goniometer::paintReadout (Graphics& g) const
+{
+    // The buffer is resized by prepare() so only read it under the lock
+    auto numChannels = 0;
+    {
+        const ScopedLock sl (criticalSection);
+        numChannels = buffer.getNumChannels();
+    }
+    if (numChannels < 2)
+        return;
+
+    g.setColour (Colours::grey);
+    g.setFont (Font (GUI_SIZE_F(0.4)));
+    auto bounds = getLocalBounds().reduced (GUI_SIZE_I(0.1));
+    const auto lblH = GUI_SIZE_I(0.5);
+
+    const auto corr = getCorrelation();
+    g.drawText ("Corr " + String (corr, 2), bounds.withHeight (lblH), Justification::topLeft, false);
+
+    const auto balance = getBalanceDb();
+    String balanceStr = "C";
+    if (std::abs (balance) >= 0.05f)
+        balanceStr = (balance > 0.0f ? "L " : "R ") + String (std::abs (balance), 1) + " dB";
+    g.drawText ("Bal " + balanceStr, bounds.withHeight (lblH), Justification::topRight, false);
+
+    // Draw a correlation bar along the bottom (-1 on the left, +1 on the right)
+    const auto bar = bounds.removeFromBottom (GUI_SIZE_I(0.15)).toFloat();
+    g.setColour (Colours::darkgrey.darker());
+    g.fillRect (bar);
+    const auto markerX = bar.getCentreX() + corr * bar.getWidth() * 0.5f;
+    g.setColour (corr < 0.0f ? Colours::red : Colours::green);
+    g.fillRect (Rectangle<float> (jmin (markerX, bar.getCentreX()), bar.getY(), std::abs (markerX - bar.getCentreX()) + 1.0f, bar.getHeight()));
+}
 void Goniometer::paintScale (Graphics& g) const
 {
     // To speed things up we make sure we stay within the graphics context so we can disable clipping at the component level
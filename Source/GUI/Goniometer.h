@@ -11,7 +11,13 @@
 #pragma once
 
 #include "../Processing/AudioScopeProcessor.h"
+#include "BackgroundRenderer.h"
 
+/**
+*   Displays the stereo image of the first two channels as a mid/side plot. Samples are accumulated into a density buffer which
+*   decays over time (like the persistence of a phosphor screen) and is mapped through a colour lookup table, so the display shows
+*   where the signal spends its time rather than just the latest frame. The phase correlation and balance are measured in the same pass.
+*/
 class Goniometer final : public Component, public Timer
 {
 public:
@@ -24,6 +30,7 @@ public:
     
     // As the frame size for the audioScopeProcessor is set to 4096, updates arrive at ~11 Hz for a sample rate of 44.1 KHz.
     // Instead of repainting on a fixed timer we poll an atomic flag set from the audio thread to see if there is fresh data.
+    // Between frames (or once the signal stops) we keep rendering until the density has decayed to nothing.
     void timerCallback() override;
 
     void assignAudioScopeProcessor (AudioScopeProcessor* audioScopeProcessorPtr);
@@ -31,6 +38,15 @@ public:
     // Must be called after AudioScopeProcessor:prepare() so that the AudioProbe listeners can be set up properly
     void prepare();
 
+    // Must be called before AudioScopeProcessor:prepare() because the waveform is read on the render thread (prepare() restarts rendering)
+    void stopRendering();
+
+    /** Gets the phase correlation of the latest frame (+1 for mono, 0 for uncorrelated, -1 for out of phase). */
+    float getCorrelation() const;
+
+    /** Gets the balance of the latest frame in dB (positive if the left channel is louder). */
+    float getBalanceDb() const;
+
 private:
 
     class Background final : public Component
@@ -51,7 +67,11 @@ private:
         Goniometer* parentScope;
     };
 
+    bool renderWaveform (Graphics& g);
+    void accumulateFrame();
+    void updateDensityImage();
     void paintWaveform (Graphics& g) const;
+    void paintReadout (Graphics& g) const;
     void paintScale (Graphics& g) const;
     Rectangle<int> getPlotBounds() const;
 
@@ -59,11 +79,30 @@ private:
     Foreground foreground;
 	AudioScopeProcessor* audioScopeProcessor;
     AudioBuffer<float> buffer;
+    Rectangle<int> plotBounds;
     CriticalSection criticalSection;
+
+    static constexpr int lutSize = 256;
+    static constexpr float densityToLutIndex = 8.0f;    // LUT entries per hit
+    static constexpr double persistenceSeconds = 0.25;  // Time constant for the density to decay
+    HeapBlock<PixelARGB> colourLut;
+    HeapBlock<float> density;
+    HeapBlock<float> xPx, yPx;
+    int densitySize = 0;
+    Image densityImage;
+    double lastRenderTime = 0.0;
+    Atomic<bool> frameToAccumulate;
+    Atomic<bool> densityVisible;
+    Atomic<float> correlation;
+    Atomic<float> balanceDb;
+
     ListenerRemovalCallback removeListenerCallback = {};
     WeakReference<Goniometer>::Master masterReference;
     friend class WeakReference<Goniometer>;
     Atomic<bool> dataFrameReady;
 
+    // Renders the waveform on a worker thread (view state shared with the render thread is protected by criticalSection)
+    BackgroundRenderer renderer;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Goniometer)
 };
\ No newline at end of file
@@ -11,6 +11,9 @@
 #include "MainComponent.h"
 #include "../Main.h"
 #include "../Processing/ProcessorExamples.h"
+#include "../Processing/PluginProcessorHarness.h"
+#include "../Processing/ProcessorChain.h"
+#include "../Processing/OversamplingHarness.h"
 
 MainContentComponent::MainContentComponent (AudioDeviceManager& deviceManager)
     : AudioAppComponent (deviceManager)
@@ -23,10 +26,64 @@ MainContentComponent::MainContentComponent (AudioDeviceManager& deviceManager)
 // =================================================================================================================================
 // +++      Here is where to instantiate the processors being tested (it's OK to leave one as nullptr if you don't need it)      +++
 // =================================================================================================================================
-    procComponentA = std::make_unique<ProcessorComponent> ("A", new LpfExample());
-    procComponentB = std::make_unique<ProcessorComponent> ("B", new ThruExample());
+    // A processor built as a shared library (see ProcessorPluginApi.h and Examples/ProcessorPlugin) is used in place of the one given
+    // below if its path is set as ProcessorLibraryA or ProcessorLibraryB in the settings file, so it can be tested without rebuilding
+    // the testbench (and it's reloaded whenever the library is rebuilt). A relative path is relative to the folder of the settings file.
+    const auto createPluginFromSettings = [] (const String& slotId) -> ProcessorHarness*
+    {
+        auto* settings = DSPTestbenchApplication::getApp().appProperties.getUserSettings();
+        const auto key = "ProcessorLibrary" + slotId;
+        if (!settings->containsKey (key))
+            settings->setValue (key, String()); // So that the setting can be found in the file
+        const auto libraryPath = settings->getValue (key).trim();
+        if (libraryPath.isEmpty())
+            return nullptr;
+        return new PluginProcessorHarness (settings->getFile().getParentDirectory().getChildFile (libraryPath));
+    };
+    auto* pluginA = createPluginFromSettings ("A");
+    auto* pluginB = createPluginFromSettings ("B");
+
+    // Set ExampleChainB to 1 in the settings file to run a chain of processors (each in series, or in parallel with the one before)
+    // in slot B instead of the straight-through path - here an LPF, then an LPF mixed with the dry signal
+    const auto createExampleChainFromSettings = [] () -> ProcessorHarness*
+    {
+        auto* settings = DSPTestbenchApplication::getApp().appProperties.getUserSettings();
+        if (!settings->containsKey ("ExampleChainB"))
+            settings->setValue ("ExampleChainB", false); // So that the setting can be found in the file
+        if (!settings->getBoolValue ("ExampleChainB"))
+            return nullptr;
+        return new ProcessorChain ({ { new LpfExample() }, { new LpfExample() }, { new ThruExample(), ProcessorChain::Connection::parallel } });
+    };
+    auto* chainB = pluginB != nullptr ? nullptr : createExampleChainFromSettings();
+
+    // Set ProcessorOversamplingA or ProcessorOversamplingB in the settings file to 2, 4 or 8 to run that processor oversampled, so its
+    // aliasing can be compared against the extra cost (which the benchmark reports per stage). The half-band filters are polyphase IIR,
+    // or equiripple FIR if ProcessorOversamplingFilterA/B is set to FIR. Any other factor runs the processor as it is.
+    const auto oversampleFromSettings = [] (const String& slotId, ProcessorHarness* processor) -> ProcessorHarness*
+    {
+        auto* settings = DSPTestbenchApplication::getApp().appProperties.getUserSettings();
+        const auto factorKey = "ProcessorOversampling" + slotId;
+        const auto filterKey = "ProcessorOversamplingFilter" + slotId;
+        if (!settings->containsKey (factorKey))
+            settings->setValue (factorKey, 1); // So that the settings can be found in the file
+        if (!settings->containsKey (filterKey))
+            settings->setValue (filterKey, "IIR");
+        const auto factor = settings->getIntValue (factorKey, 1);
+        if (factor != 2 && factor != 4 && factor != 8)
+            return processor;
+        const auto numStages = factor == 2 ? 1 : (factor == 4 ? 2 : 3);
+        const auto filterType = settings->getValue (filterKey).trim().equalsIgnoreCase ("FIR") ? OversamplingHarness::FilterType::filterHalfBandFIREquiripple
+                                                                                                : OversamplingHarness::FilterType::filterHalfBandPolyphaseIIR;
+        return new OversamplingHarness (std::unique_ptr<ProcessorHarness> (processor), numStages, filterType);
+    };
+
+    procComponentA = std::make_unique<ProcessorComponent> ("A", oversampleFromSettings ("A", pluginA != nullptr ? pluginA : new LpfExample()));
+    procComponentB = std::make_unique<ProcessorComponent> ("B", oversampleFromSettings ("B", pluginB != nullptr ? pluginB : chainB != nullptr ? chainB : new ThruExample()));
 // =================================================================================================================================
 
+    procComponentA->setDeviceManager (&deviceManager);
+    procComponentB->setDeviceManager (&deviceManager);
+
     analyserComponent = std::make_unique<AnalyserComponent>();
     monitoringComponent = std::make_unique<MonitoringComponent> (&deviceManager, procComponentA.get(), procComponentB.get());
 
@@ -124,11 +181,8 @@ void MainContentComponent::getNextAudioBlock (const AudioSourceChannelInfo& buff
     if (analyserComponent->isProcessing())
         analyserComponent->process (dsp::ProcessContextReplacing<float> (outputBlock));
 
-    // Run audio through monitoring section
-    if (monitoringComponent->isMuted())
-        outputBlock.clear();
-    else
-        monitoringComponent->process (dsp::ProcessContextReplacing<float> (outputBlock));
+    // Run audio through monitoring section (which clears the output if muted, after measuring loudness)
+    monitoringComponent->process (dsp::ProcessContextReplacing<float> (outputBlock));
 
     if (holdAudio.get())
     {
@@ -270,6 +324,11 @@ SourceComponent* MainContentComponent::getSourceComponentA()
 {
     return srcComponentA.get();
 }
+void MainContentComponent::renderSourceA (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination)
+{
+    jassert (destination.getNumChannels() == spec.numChannels && destination.getNumSamples() % spec.maximumBlockSize == 0);
+    srcComponentA->render (spec, destination);
+}
 void MainContentComponent::routeSourcesAndProcess (ProcessorComponent* processor, dsp::AudioBlock<float>& temporaryBuffer)
 {
     // Route signal sources
@@ -39,6 +39,11 @@ public:
     ProcessorHarness* getProcessorHarness (const int index);
     SourceComponent* getSourceComponentA();
 
+    /** Renders consecutive blocks from source A into the destination (whose length must be a whole number of blocks) at the given
+     *  ProcessSpec. This uses separate generators set up from source A's settings, so it can be called while audio is running without
+     *  disturbing the live sources (see SourceComponent::render). */
+    void renderSourceA (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination);
+
 private:
 
     ThreadPool threadPool;
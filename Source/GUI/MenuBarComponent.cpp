@@ -73,28 +73,22 @@ DspTestBenchMenuComponent::DspTestBenchMenuComponent (MainContentComponent* main
     btnBenchmark->setTooltip ("Run performance benchmarks");
     btnBenchmark->onClick = [this]
     {
-        auto* deviceMgr = DSPTestbenchApplication::getApp().getMainWindow().getAudioDeviceManager();
-        auto* currentDevice = deviceMgr->getCurrentAudioDevice();
-        if (currentDevice)
-        {
-            deviceMgr->closeAudioDevice();
-            DialogWindow::LaunchOptions launchOptions;
-            launchOptions.dialogTitle = "Performance benchmarks";
-            launchOptions.useNativeTitleBar = false;
-            launchOptions.dialogBackgroundColour = cols::componentBackground();
-            launchOptions.componentToCentreAround = mainContentComponent;
-            launchOptions.content.set (new BenchmarkComponent (
-                mainContentComponent->getProcessorHarness (0),
-                mainContentComponent->getProcessorHarness (1),
-                mainContentComponent->getSourceComponentA()
-            ), true);
-            launchOptions.resizable = false;
-            launchOptions.launchAsync();
-        }
-        else
-        {
-            AlertWindow::showMessageBoxAsync (AlertWindow::AlertIconType::WarningIcon, "Audio device problem", "No current audio device, please check your settings.");
-        }
+        // The benchmarks run on separate instances of the processors, so the audio device keeps running
+        DialogWindow::LaunchOptions launchOptions;
+        launchOptions.dialogTitle = "Performance benchmarks";
+        launchOptions.useNativeTitleBar = false;
+        launchOptions.dialogBackgroundColour = cols::componentBackground();
+        launchOptions.componentToCentreAround = mainContentComponent;
+        launchOptions.content.set (new BenchmarkComponent (
+            mainContentComponent->getProcessorHarness (0),
+            mainContentComponent->getProcessorHarness (1),
+            [mainContent = mainContentComponent] (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination)
+            {
+                mainContent->renderSourceA (spec, destination);
+            }
+        ), true);
+        launchOptions.resizable = false;
+        launchOptions.launchAsync();
     };
 
     btnAudioDevice = std::make_unique<DrawableButton> ("Audio Settings", DrawableButton::ImageFitted);
@@ -9,109 +9,227 @@
 */
 
 #include "MeteringComponents.h"
-#include "AnalyserComponent.h"
 
-MeterBar::MeterBar()
+MeterBridge::MeterBridge()
 {
-    init();
+    setPaintingIsUnclipped (true);
+    setRange (minDb, maxDb);
 }
-MeterBar::MeterBar(const float minimumLevelDb, const float cautionLevelDb,
-    const float alertLevelDb, const float maximumLevelDb)
+void MeterBridge::paint (Graphics& g)
 {
-    minDb       = minimumLevelDb;
-    cautionDb   = cautionLevelDb;
-    alertDb     = alertLevelDb;
-    maxDb       = maximumLevelDb;
-    rangeDb     = maximumLevelDb - minimumLevelDb;
+    for (auto ch = 0; ch < numChannels; ++ch)
+    {
+        const auto& bounds = channelBounds[static_cast<size_t> (ch)];
 
-    init();
+        if (!bounds.vuBar.isEmpty() && g.clipRegionIntersects (bounds.vuBar))
+            drawBar (g, bounds.vuBar, vuLevelsY[ch], vuBarImage);
+
+        if (!bounds.peakBar.isEmpty() && g.clipRegionIntersects (bounds.peakBar))
+            drawBar (g, bounds.peakBar, peakLevelsY[ch], peakBarImage);
+
+        if (clipProcessor && !bounds.clipIndicator.isEmpty() && g.clipRegionIntersects (bounds.clipIndicator))
+        {
+            g.setColour (clipped[ch] ? Colours::red : Colours::white.withAlpha (0.5f));
+            g.setFont (static_cast<float> (bounds.clipIndicator.getHeight()) * 0.8f);
+            g.drawFittedText ("CLIP", bounds.clipIndicator, Justification::centredTop, 1);
+        }
+    }
 }
-void MeterBar::init()
+bool MeterBridge::hitTest (int x, int y)
 {
-    setPaintingIsUnclipped (true);
-    setOpaque (backgroundColour.isOpaque());
-}
-void MeterBar::paint (Graphics& g)
-{
-    auto colourNormal  = Colours::lime;
-	auto colourCaution = Colours::yellow;
-	auto colourAlert   = Colours::red;
-
-    const auto fullHeight = static_cast<float> (getHeight());
-	const auto gradientHeight = fullHeight * 0.5f;
-	const auto fullWidth = static_cast<float> (getWidth());
-	const auto darkShadow = 0.5f;
-
-    g.setColour (backgroundColour);
-    g.fillRect (0.0f, 0.0f, fullWidth, fullHeight);
-
-    auto y = jmax (currentLevelY, cautionY);
-	//g.setColour (colourNormal);
-	g.setGradientFill (	ColourGradient	(	colourNormal, 0.0f, gradientHeight,
-											colourNormal.darker (darkShadow), fullWidth, gradientHeight,
-											false) );
-    g.fillRect(0.0f, y, fullWidth, fullHeight - y);
-	
-    if (currentLevelY < cautionY)
-	{
-        y = jmax (currentLevelY, alertY);
-		//g.setColour (colourCaution);
-		g.setGradientFill (	ColourGradient	(	colourCaution, 0.0f, gradientHeight,
-												colourCaution.darker(darkShadow), fullWidth, gradientHeight,
-												false) );
-        g.fillRect (0.0f, y, fullWidth, cautionY - y);
-	}
-
-    if (currentLevelY < alertY)
-	{
-		//g.setColour (colourAlert);
-		g.setGradientFill (	ColourGradient	(	colourAlert, 0.0f, gradientHeight,
-												colourAlert.darker (darkShadow), fullWidth, gradientHeight,
-												false) );
-        g.fillRect (0.0f, currentLevelY, fullWidth, alertY - currentLevelY);
-	}
-}
-void MeterBar::resized ()
-{
-    rangeDb = maxDb - minDb;
+    // Let clicks through to whatever is behind, except where there is something to click or a tooltip to show
+    auto isOverClipIndicator = false;
+    const auto channel = getChannelAt ({ x, y }, isOverClipIndicator);
+    return channel >= 0 && (isOverClipIndicator || channelTooltip.isNotEmpty());
+}
+void MeterBridge::mouseDown (const MouseEvent& event)
+{
+    auto isOverClipIndicator = false;
+    getChannelAt (event.getPosition(), isOverClipIndicator);
+    if (isOverClipIndicator && onClipIndicatorClicked)
+        onClipIndicatorClicked();
+}
+String MeterBridge::getTooltip()
+{
+    auto isOverClipIndicator = false;
+    const auto channel = getChannelAt (getMouseXYRelative(), isOverClipIndicator);
+    if (isOverClipIndicator)
+        return "Click to show clip stats";
+    if (channel >= 0 && channelTooltip.isNotEmpty())
+        return channelTooltip + String (channel);
+    return {};
+}
+void MeterBridge::assignProcessors (PeakMeterProcessor* peakMeterProcessor, VUMeterProcessor* vuMeterProcessor, ClipCounterProcessor* clipCounterProcessor)
+{
+    peakProcessor = peakMeterProcessor;
+    vuProcessor = vuMeterProcessor;
+    clipProcessor = clipCounterProcessor;
+}
+void MeterBridge::setNumChannels (const int numberOfChannels)
+{
+    numChannels = jmax (0, numberOfChannels);
+    const auto n = static_cast<size_t> (numChannels);
+
+    channelBounds.assign (n, {});
+    peakLevelsDb.allocate (n, false);
+    vuLevelsDb.allocate (n, false);
+    FloatVectorOperations::fill (peakLevelsDb, noSignalDbLevel, numChannels);
+    FloatVectorOperations::fill (vuLevelsDb, noSignalDbLevel, numChannels);
+    peakLevelsY.allocate (n, true);
+    vuLevelsY.allocate (n, true);
+    clipped.allocate (n, true);
+    repaint();
+}
+int MeterBridge::getNumChannels() const
+{
+    return numChannels;
+}
+void MeterBridge::setChannelBounds (const int channel, const ChannelBounds& newBounds)
+{
+    jassert (isPositiveAndBelow (channel, numChannels));
+    if (!isPositiveAndBelow (channel, numChannels))
+        return;
+
+    channelBounds[static_cast<size_t> (channel)] = newBounds;
+    peakLevelsY[channel] = dBtoPx (peakLevelsDb[channel], newBounds.peakBar.getHeight());
+    vuLevelsY[channel] = dBtoPx (vuLevelsDb[channel], newBounds.vuBar.getHeight());
+    repaint();
+}
+void MeterBridge::setRange (const float minimumDb, const float maximumDb)
+{
+    minDb = minimumDb;
+    maxDb = maximumDb;
+    const auto rangeDb = maxDb - minDb;
     maxExp = dsp::FastMathApproximations::exp (maxDb / rangeDb);
-    const auto minExp = dsp::FastMathApproximations::exp (minDb / rangeDb);
-    scaling    = getHeight() / (maxExp - minExp);
-    currentLevelY       = dBtoPx (currentLevelDb);
-    cautionY            = dBtoPx (cautionDb);
-    alertY              = dBtoPx (alertDb);
+    minExp = dsp::FastMathApproximations::exp (minDb / rangeDb);
+
+    // Force the bars to be re-rendered
+    peakBarImage = {};
+    vuBarImage = {};
+    repaint();
 }
-void MeterBar::setLevel (const float dB)
+void MeterBridge::setBarBackgroundColour (const Colour newBackgroundColour)
 {
-    currentLevelDb = dB;
-    currentLevelY = dBtoPx (dB);
+    barBackgroundColour = newBackgroundColour;
     repaint();
 }
-void MeterBar::setMinDb (const float dB)
+void MeterBridge::setChannelTooltip (const String& tooltipPrefix)
 {
-    minDb = dB;
-    resized();
+    channelTooltip = tooltipPrefix;
 }
-void MeterBar::setMaxDb (const float dB)
+void MeterBridge::setActive (const bool shouldBeActive)
 {
-    maxDb = dB;
-    resized();
+    active = shouldBeActive;
 }
-void MeterBar::setBackgroundColour (const Colour newBackgroundColour)
+void MeterBridge::refresh()
 {
-    backgroundColour = newBackgroundColour;
-    setOpaque (backgroundColour.isOpaque());
+    if (numChannels == 0)
+        return;
+
+    // One snapshot of all channels from each processor
+    if (active && peakProcessor)
+        peakProcessor->getLevelsDb (peakLevelsDb, numChannels);
+    else
+        FloatVectorOperations::fill (peakLevelsDb, noSignalDbLevel, numChannels);
+
+    if (active && vuProcessor)
+        vuProcessor->getLevelsDb (vuLevelsDb, numChannels);
+    else
+        FloatVectorOperations::fill (vuLevelsDb, noSignalDbLevel, numChannels);
+
+    // Only repaint what has moved
+    for (auto ch = 0; ch < numChannels; ++ch)
+    {
+        const auto& bounds = channelBounds[static_cast<size_t> (ch)];
+
+        const auto newPeakY = dBtoPx (peakLevelsDb[ch], bounds.peakBar.getHeight());
+        if (newPeakY != peakLevelsY[ch])
+        {
+            repaintBar (bounds.peakBar, peakLevelsY[ch], newPeakY);
+            peakLevelsY[ch] = newPeakY;
+        }
+
+        const auto newVuY = dBtoPx (vuLevelsDb[ch], bounds.vuBar.getHeight());
+        if (newVuY != vuLevelsY[ch])
+        {
+            repaintBar (bounds.vuBar, vuLevelsY[ch], newVuY);
+            vuLevelsY[ch] = newVuY;
+        }
+
+        const auto isClipped = clipProcessor && clipProcessor->getNumClipEvents (ch) > 0;
+        if (isClipped != clipped[ch])
+        {
+            clipped[ch] = isClipped;
+            repaint (bounds.clipIndicator);
+        }
+    }
 }
-float MeterBar::dBtoPx (const float dB) const
+int MeterBridge::dBtoPx (const float dB, const int barHeight) const
 {
     if (dB <= minDb)
-        return static_cast<float> (getHeight());
-    else
+        return barHeight;
+
+    const auto dbClipped = jlimit (minDb, maxDb, dB);
+    const auto dbExp = dsp::FastMathApproximations::exp (dbClipped / (maxDb - minDb));
+    return roundToInt ((maxExp - dbExp) / (maxExp - minExp) * static_cast<float> (barHeight));
+}
+int MeterBridge::getChannelAt (const Point<int> position, bool& isOverClipIndicator) const
+{
+    for (auto ch = 0; ch < numChannels; ++ch)
+    {
+        const auto& bounds = channelBounds[static_cast<size_t> (ch)];
+        isOverClipIndicator = clipProcessor && bounds.clipIndicator.contains (position);
+        if (isOverClipIndicator || bounds.peakBar.contains (position) || bounds.vuBar.contains (position))
+            return ch;
+    }
+    isOverClipIndicator = false;
+    return -1;
+}
+void MeterBridge::drawBar (Graphics& g, const Rectangle<int>& bar, const int levelY, Image& barImage)
+{
+    if (!barBackgroundColour.isTransparent())
     {
-        const auto dbClipped = jlimit (minDb, maxDb, dB);
-        const auto dbExp = dsp::FastMathApproximations::exp (dbClipped / rangeDb);
-        return (maxExp - dbExp) * scaling;
+        g.setColour (barBackgroundColour);
+        g.fillRect (bar);
     }
+
+    if (barImage.getWidth() != bar.getWidth() || barImage.getHeight() != bar.getHeight())
+        renderBarImage (barImage, bar.getWidth(), bar.getHeight());
+
+    const auto levelHeight = bar.getHeight() - levelY;
+    if (levelHeight > 0)
+        g.drawImage (barImage, bar.getX(), bar.getY() + levelY, bar.getWidth(), levelHeight, 0, levelY, bar.getWidth(), levelHeight);
+}
+void MeterBridge::renderBarImage (Image& barImage, const int width, const int height) const
+{
+    const auto colourNormal  = Colours::lime;
+    const auto colourCaution = Colours::yellow;
+    const auto colourAlert   = Colours::red;
+    const auto darkShadow = 0.5f;
+
+    barImage = Image (Image::ARGB, jmax (1, width), jmax (1, height), true);
+    Graphics g (barImage);
+
+    const auto fullWidth = static_cast<float> (width);
+    const auto gradientHeight = static_cast<float> (height) * 0.5f;
+    const auto cautionY = static_cast<float> (dBtoPx (cautionDb, height));
+    const auto alertY = static_cast<float> (dBtoPx (alertDb, height));
+
+    g.setGradientFill (ColourGradient (colourNormal, 0.0f, gradientHeight, colourNormal.darker (darkShadow), fullWidth, gradientHeight, false));
+    g.fillRect (0.0f, cautionY, fullWidth, static_cast<float> (height) - cautionY);
+
+    g.setGradientFill (ColourGradient (colourCaution, 0.0f, gradientHeight, colourCaution.darker (darkShadow), fullWidth, gradientHeight, false));
+    g.fillRect (0.0f, alertY, fullWidth, cautionY - alertY);
+
+    g.setGradientFill (ColourGradient (colourAlert, 0.0f, gradientHeight, colourAlert.darker (darkShadow), fullWidth, gradientHeight, false));
+    g.fillRect (0.0f, 0.0f, fullWidth, alertY);
+}
+void MeterBridge::repaintBar (const Rectangle<int>& bar, const int oldLevelY, const int newLevelY)
+{
+    // Each bar is repainted separately so that the dirty region doesn't cover anything in between the bars
+    const auto top = bar.getY() + jmin (oldLevelY, newLevelY);
+    const auto bottom = bar.getY() + jmax (oldLevelY, newLevelY);
+    repaint (bar.withTop (top).withBottom (bottom));
 }
 
 MainMeterBackground::MainMeterBackground()  // NOLINT(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
@@ -229,6 +347,8 @@ ClipStatsComponent::ClipStatsComponent()  // NOLINT(cppcoreguidelines-pro-type-m
     lblClipEventsTitle.setText ("Clip events", dontSendNotification);
     lblAvgEventLengthTitle.setText ("Avg clip length", dontSendNotification);
     lblMaxEventLengthTitle.setText ("Max clip length", dontSendNotification);
+    lblMaxTruePeakTitle.setText ("Max true peak", dontSendNotification);
+    lblMaxTruePeakTitle.setTooltip ("Maximum inter-sample peak level since reset (dBTP)");
 
     btnReset.setButtonText ("Reset");
     btnReset.setColour (ComboBox::outlineColourId, Colours::darkgrey);
@@ -238,12 +358,15 @@ ClipStatsComponent::ClipStatsComponent()  // NOLINT(cppcoreguidelines-pro-type-m
     {
         if (processor)
             processor->reset();
+        if (truePeakProcessor)
+            truePeakProcessor->reset();
     };
 
     addAndMakeVisible (lblClippedSamplesTitle);
     addAndMakeVisible (lblClipEventsTitle);
     addAndMakeVisible (lblAvgEventLengthTitle);
     addAndMakeVisible (lblMaxEventLengthTitle);
+    addAndMakeVisible (lblMaxTruePeakTitle);
     addAndMakeVisible (btnReset);
 
     setSize (getDesiredWidth(), getDesiredHeight());
@@ -264,6 +387,7 @@ void ClipStatsComponent::resized()
         Track (GUI_SIZE_PX (rowHeight)),
         Track (GUI_SIZE_PX (rowHeight)),
         Track (GUI_SIZE_PX (rowHeight)),
+        Track (GUI_SIZE_PX (rowHeight)),
     };
     grid.templateColumns = { Track (GUI_SIZE_PX (headingWidth)), Track (GUI_GAP_PX (spacerWidth)) };
     grid.autoColumns = Track (GUI_SIZE_PX (channelWidth));
@@ -272,7 +396,8 @@ void ClipStatsComponent::resized()
         GridItem (lblClippedSamplesTitle).withArea (2, 1),
         GridItem (lblClipEventsTitle).withArea (3, 1),
         GridItem (lblAvgEventLengthTitle).withArea (4, 1),
-        GridItem (lblMaxEventLengthTitle).withArea (5, 1)
+        GridItem (lblMaxEventLengthTitle).withArea (5, 1),
+        GridItem (lblMaxTruePeakTitle).withArea (6, 1)
     });
     for (auto ch = 0; ch < numChannels; ++ch)
     {
@@ -281,7 +406,8 @@ void ClipStatsComponent::resized()
             GridItem (lblClippedSamples[ch]).withArea (2, ch + 3),
             GridItem (lblClipEvents[ch]).withArea (3, ch + 3),
             GridItem (lblAvgEventLength[ch]).withArea (4, ch + 3),
-            GridItem (lblMaxEventLength[ch]).withArea (5, ch + 3)
+            GridItem (lblMaxEventLength[ch]).withArea (5, ch + 3),
+            GridItem (lblMaxTruePeak[ch]).withArea (6, ch + 3)
         });
     }
     grid.performLayout (getLocalBounds().reduced (GUI_GAP_I (gap)));
@@ -295,6 +421,7 @@ void ClipStatsComponent::setNumChannels(const int numberOfChannels)
     lblClipEvents.clear();
     lblAvgEventLength.clear();
     lblMaxEventLength.clear();
+    lblMaxTruePeak.clear();
 
     for (auto ch = 0; ch < numberOfChannels; ++ch)
     {
@@ -303,6 +430,7 @@ void ClipStatsComponent::setNumChannels(const int numberOfChannels)
         addAndMakeVisible (lblClipEvents.add (new Label()));
         addAndMakeVisible (lblAvgEventLength.add (new Label()));
         addAndMakeVisible (lblMaxEventLength.add (new Label()));
+        addAndMakeVisible (lblMaxTruePeak.add (new Label()));
         
         lblChannelHeadings[ch]->setFont( Font(GUI_SIZE_I(0.7), Font::bold));
         lblChannelHeadings[ch]->setJustificationType (Justification::centred);
@@ -311,6 +439,7 @@ void ClipStatsComponent::setNumChannels(const int numberOfChannels)
         lblClipEvents[ch]->setJustificationType (Justification::centred);
         lblAvgEventLength[ch]->setJustificationType (Justification::centred);
         lblMaxEventLength[ch]->setJustificationType (Justification::centred);
+        lblMaxTruePeak[ch]->setJustificationType (Justification::centred);
     }
 
     setSize (getDesiredWidth(), getDesiredHeight());
@@ -319,6 +448,10 @@ void ClipStatsComponent::assignProcessor (ClipCounterProcessor* clipCounterProce
 {
     processor = clipCounterProcessor;
 }
+void ClipStatsComponent::assignTruePeakProcessor (TruePeakMeterProcessor* truePeakMeterProcessor)
+{
+    truePeakProcessor = truePeakMeterProcessor;
+}
 void ClipStatsComponent::updateStats()
 {
     if (!isShowing())
@@ -331,7 +464,18 @@ void ClipStatsComponent::updateStats()
         lblClipEvents[ch]->setText (String (processor->getNumClipEvents (ch)), dontSendNotification);
         lblAvgEventLength[ch]->setText (String (processor->getAvgClipLength (ch), 1), dontSendNotification);
         lblMaxEventLength[ch]->setText (String (processor->getMaxClipLength (ch)), dontSendNotification);
+        if (truePeakProcessor)
+        {
+            const auto maxTruePeak = truePeakProcessor->getMaxLevelDb (ch);
+            lblMaxTruePeak[ch]->setText (maxTruePeak > -100.0f ? String (maxTruePeak, 1) : String ("-inf"), dontSendNotification);
+            lblMaxTruePeak[ch]->setColour (Label::textColourId, maxTruePeak > -1.0f ? Colours::red : Colours::white);
+        }
     }
+
+    // Make the cost of true-peak metering visible, as it is by far the most expensive of the meters
+    if (truePeakProcessor)
+        lblMaxTruePeakTitle.setTooltip ("Maximum inter-sample peak level since reset (dBTP)\nTrue-peak meter CPU load: "
+                                        + String (truePeakProcessor->getCpuLoad() * 100.0, 2) + "%");
     repaint();
 }
 int ClipStatsComponent::getMinWidth() const
@@ -346,31 +490,5 @@ int ClipStatsComponent::getDesiredWidth() const
 }
 int ClipStatsComponent::getDesiredHeight() const
 {
-    return GUI_SIZE_I (1.0 + rowHeight * 4.0) + GUI_GAP_I (gap * 8.0);
-}
-
-ClipIndicatorComponent::ClipIndicatorComponent (const int channel, ClipCounterProcessor* clipCounterProcessorToReferTo)
-{
-    channelNumber = channel;
-    clipCounterProcessor = clipCounterProcessorToReferTo;
-}
-void ClipIndicatorComponent::paint (Graphics& g)
-{
-    if (clipCounterProcessor && clipCounterProcessor->getNumClipEvents (channelNumber) > 0)
-        g.setColour(Colours::red);
-    else
-        g.setColour(Colours::white.withAlpha (0.5f));
-
-    const float fontHeight = static_cast<float> (getHeight()) * 0.8f;
-    g.setFont (fontHeight);
-    g.drawFittedText ("CLIP", 0, 0, getWidth(), getHeight(), Justification::centredTop, 1);
-}
-void ClipIndicatorComponent::mouseDown (const MouseEvent&)
-{
-    auto* parent = dynamic_cast<AnalyserComponent*> (getParentComponent());
-    parent->showClipStats();
-}
-String ClipIndicatorComponent::getTooltip()
-{
-    return String("Click to show clip stats");
+    return GUI_SIZE_I (1.0 + rowHeight * 5.0) + GUI_GAP_I (gap * 9.0);
 }
@@ -12,50 +12,95 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "../Processing/MeteringProcessors.h"
+#include <vector>
 
-/** 
-*  A 3 colour vertical meter bar component with dB levels mapped exponentially.
+/**
+*  Draws the 3 colour level meters (with dB levels mapped exponentially) for every channel in one component, so that the GUI cost
+*  stays flat as the channel count grows.
+*
+*  Each refresh takes one snapshot of all the channel levels from the processors and repaints only the part of each bar which has
+*  moved. All the bars are then drawn in a single paint pass by copying slices of a pre-rendered full scale bar. A narrower VU bar
+*  and a clip indicator can optionally be drawn for each channel too.
 */
-class MeterBar final : public Component, public SettableTooltipClient
+class MeterBridge final : public Component, public TooltipClient
 {
 public:
-	
-    MeterBar();
-    MeterBar (
-        const float minimumLevelDb,
-        const float cautionLevelDb,
-        const float alertLevelDb,
-        const float maximumLevelDb
-    );
-    ~MeterBar() override = default;
 
-    void paint (Graphics&) override;
-    void resized() override;
+    /** The bounds of the parts of a channel's meter, relative to the bridge. Parts with empty bounds aren't drawn. */
+    struct ChannelBounds
+    {
+        Rectangle<int> peakBar;
+        Rectangle<int> vuBar;
+        Rectangle<int> clipIndicator;
+    };
+
+    MeterBridge();
+    ~MeterBridge() override = default;
+
+    void paint (Graphics& g) override;
+    bool hitTest (int x, int y) override;
+    void mouseDown (const MouseEvent& event) override;
+    String getTooltip() override;
 
-    void setLevel (const float dB);
-    void setMinDb (const float dB);
-    void setMaxDb (const float dB);
-    void setBackgroundColour (const Colour newBackgroundColour);
+    //  Assign the processors that this component will reference (the VU meter and clip counter are optional)
+    void assignProcessors (PeakMeterProcessor* peakMeterProcessor,
+                           VUMeterProcessor* vuMeterProcessor = nullptr,
+                           ClipCounterProcessor* clipCounterProcessor = nullptr);
+
+    // Set the number of channels (then set the bounds for each channel)
+    void setNumChannels (const int numberOfChannels);
+    [[nodiscard]] int getNumChannels() const;
+    void setChannelBounds (const int channel, const ChannelBounds& newBounds);
+
+    void setRange (const float minimumDb, const float maximumDb);
+    void setBarBackgroundColour (const Colour newBackgroundColour);
+
+    // Set the tooltip shown over a channel's bars, to which the channel number is appended (no tooltip if empty)
+    void setChannelTooltip (const String& tooltipPrefix);
+
+    // The meters show no signal while inactive
+    void setActive (const bool shouldBeActive);
+
+    //  Take a snapshot of the levels from the referenced processors and repaint any bars which have changed
+    void refresh();
+
+    // Called when a clip indicator is clicked
+    std::function<void()> onClipIndicatorClicked;
 
 private:
 
-    void init();
-    [[nodiscard]] float dBtoPx (const float dB) const;
+    [[nodiscard]] int dBtoPx (const float dB, const int barHeight) const;
+    [[nodiscard]] int getChannelAt (const Point<int> position, bool& isOverClipIndicator) const;
+    void drawBar (Graphics& g, const Rectangle<int>& bar, const int levelY, Image& barImage);
+    void renderBarImage (Image& barImage, const int width, const int height) const;
+    void repaintBar (const Rectangle<int>& bar, const int oldLevelY, const int newLevelY);
+
+    PeakMeterProcessor* peakProcessor{};
+    VUMeterProcessor* vuProcessor{};
+    ClipCounterProcessor* clipProcessor{};
+
+    int numChannels = 0;
+    std::vector<ChannelBounds> channelBounds{};
+    HeapBlock<float> peakLevelsDb{};
+    HeapBlock<float> vuLevelsDb{};
+    HeapBlock<int> peakLevelsY{};           // Top of each bar as last painted (relative to the bar)
+    HeapBlock<int> vuLevelsY{};
+    HeapBlock<bool> clipped{};
+    Image peakBarImage{};                   // Full scale bars, from which the bars are drawn
+    Image vuBarImage{};
 
     float minDb       = -60.0f;
     float cautionDb   = -12.0f;
     float alertDb     = -6.0f;
     float maxDb       = 6.0f;
-    float rangeDb     = maxDb - minDb;
     float maxExp      = 0.0f;
-    float cautionY {};
-    float alertY {};
-    float scaling = 1.0f;
-    float currentLevelDb = -150.0f;
-    float currentLevelY = 0.0f;
-    Colour backgroundColour = Colours::black;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeterBar)
+    float minExp      = 0.0f;
+    Colour barBackgroundColour = Colours::black;
+    String channelTooltip{};
+    bool active = true;
+    const float noSignalDbLevel = -150.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeterBridge)
 };
 
 /**
@@ -120,6 +165,9 @@ public:
     //  Assign the processor that this component will reference
     void assignProcessor (ClipCounterProcessor* clipCounterProcessor);
 
+    //  Assign the true-peak processor that this component will reference
+    void assignTruePeakProcessor (TruePeakMeterProcessor* truePeakMeterProcessor);
+
     //  Update the statistics displayed in this component from the referenced processor
     void updateStats();
 
@@ -131,6 +179,7 @@ private:
 
     int numChannels = 0;
     ClipCounterProcessor* processor{};
+    TruePeakMeterProcessor* truePeakProcessor{};
     const double headingWidth = 3.7;
     const double spacerWidth = 2.5;
     const double channelWidth = 1.8;
@@ -141,6 +190,7 @@ private:
     Label lblClipEventsTitle;
     Label lblAvgEventLengthTitle;
     Label lblMaxEventLengthTitle;
+    Label lblMaxTruePeakTitle;
     TextButton btnReset;
 
     OwnedArray<Label> lblChannelHeadings{};
@@ -148,26 +198,7 @@ private:
     OwnedArray<Label> lblClipEvents{};
     OwnedArray<Label> lblAvgEventLength{};
     OwnedArray<Label> lblMaxEventLength{};
+    OwnedArray<Label> lblMaxTruePeak{};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClipStatsComponent)
 };
-
-/**
- *  Displays clip indicator relating to clipping of the audio signal
- */
-class ClipIndicatorComponent final : public Component, public TooltipClient
-{
-public:
-    ClipIndicatorComponent (const int channel, ClipCounterProcessor* clipCounterProcessorToReferTo);
-    ~ClipIndicatorComponent() override = default;
-    
-    void paint (Graphics& g) override;
-    void mouseDown (const MouseEvent& event) override;
-    String getTooltip() override;
-
-private:
-    int channelNumber = 0;
-    ClipCounterProcessor* clipCounterProcessor;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClipIndicatorComponent)
-};
\ No newline at end of file
@@ -29,6 +29,10 @@ MonitoringComponent::MonitoringComponent (AudioDeviceManager* audioDeviceManager
         config->setAttribute ("OutputMute", false);
     }
 
+    limiter.setThresholdDb (limiterThresholdDb);
+    limiter.setCeilingDb (limiterCeilingDb);
+    limiter.setReleaseTime (limiterRelease);
+
     monitoringGain.setRampDurationSeconds (0.01);
 
     addAndMakeVisible (lblTitle);
@@ -84,7 +88,27 @@ MonitoringComponent::MonitoringComponent (AudioDeviceManager* audioDeviceManager
     btnLimiter.setColour (TextButton::buttonOnColourId, Colours::darkorange);
     statusLimiter = config->getBoolAttribute ("OutputLimiter");
     btnLimiter.setToggleState (statusLimiter, dontSendNotification);
-    btnLimiter.onClick = [this] { statusLimiter = btnLimiter.getToggleState(); };
+    btnLimiter.onClick = [this]
+    {
+        // Clear the limiter's delay line and envelope first, as they stop updating while it is off
+        if (btnLimiter.getToggleState())
+            limiter.reset();
+        statusLimiter = btnLimiter.getToggleState();
+    };
+
+    addAndMakeVisible (cmbLookAhead);
+    cmbLookAhead.setTooltip (TRANS("Limiter look-ahead, which ramps the gain down ahead of peaks rather than instantly (this also delays the monitoring output by the same amount)"));
+    for (auto ms : { 0, 1, 2, 5, 10, 20 })
+        cmbLookAhead.addItem (ms == 0 ? TRANS("No look-ahead") : String (ms) + " ms", ms + 1);
+    cmbLookAhead.onChange = [this]
+    {
+        limiterLookAheadMs = cmbLookAhead.getSelectedId() - 1;
+        limiter.setLookAheadTime (static_cast<float> (limiterLookAheadMs) * 0.001f);
+    };
+    cmbLookAhead.setSelectedId (jlimit (0, 20, config->getIntAttribute ("OutputLimiterLookAhead", 0)) + 1, dontSendNotification);
+    if (cmbLookAhead.getSelectedId() == 0)
+        cmbLookAhead.setSelectedId (1, dontSendNotification);
+    cmbLookAhead.onChange();
     
     addAndMakeVisible (btnMute);
     btnMute.setButtonText ("Mute");
@@ -93,12 +117,29 @@ MonitoringComponent::MonitoringComponent (AudioDeviceManager* audioDeviceManager
     statusMute = config->getBoolAttribute ("OutputMute");
     btnMute.setToggleState (statusMute, dontSendNotification);
     btnMute.onClick = [this] { statusMute = btnMute.getToggleState(); };
+
+    addAndMakeVisible (lblLoudness);
+    lblLoudness.setTooltip (TRANS("Momentary (400 ms), short-term (3 s) and integrated loudness in LUFS, and loudness range in LU (as per ITU-R BS.1770 / EBU R128), followed by the limiter gain reduction in dB when it is active"));
+    lblLoudness.setFont (Font (GUI_SIZE_F(0.5)));
+    lblLoudness.setJustificationType (Justification::centredLeft);
+    lblLoudness.setEditable (false, false, false);
+
+    addAndMakeVisible (btnLoudnessReset);
+    btnLoudnessReset.setTooltip (TRANS("Restart integrated loudness and loudness range measurement"));
+    btnLoudnessReset.setButtonText (TRANS("Reset"));
+    btnLoudnessReset.onClick = [this] { loudnessMeter.resetIntegration(); };
+
+    timerCallback();
+    startTimer (100);
 }
 MonitoringComponent::~MonitoringComponent()
 {
+    stopTimer();
+
     // Update configuration from class state
     config->setAttribute ("OutputGain", sldGain.getValue());
     config->setAttribute ("OutputLimiter", statusLimiter);
+    config->setAttribute ("OutputLimiterLookAhead", limiterLookAheadMs);
     config->setAttribute ("OutputMute", statusMute);
 
     // Save configuration to application properties
@@ -122,14 +163,17 @@ void MonitoringComponent::resized()
     grid.templateRows = {   Track (GUI_BASE_SIZE_PX)
                         };
 
-    grid.templateColumns = { Track (GUI_SIZE_PX(4)), Track (1_fr), Track (GUI_SIZE_PX(1.3)), Track (GUI_SIZE_PX(2.0)), Track (GUI_SIZE_PX(1.7)) };
+    grid.templateColumns = { Track (GUI_SIZE_PX(4)), Track (1_fr), Track (GUI_SIZE_PX(11)), Track (GUI_SIZE_PX(1.7)), Track (GUI_SIZE_PX(1.3)), Track (GUI_SIZE_PX(2.0)), Track (GUI_SIZE_PX(3.2)), Track (GUI_SIZE_PX(1.7)) };
 
     grid.autoFlow = Grid::AutoFlow::row;
 
     grid.items.addArray({   GridItem (lblTitle),
                             GridItem (sldGain).withMargin (GridItem::Margin (0.0f, GUI_GAP_F(3), 0.0f, 0.0f)),
+                            GridItem (lblLoudness),
+                            GridItem (btnLoudnessReset).withMargin (GridItem::Margin (0.0f, GUI_GAP_F(3), 0.0f, 0.0f)),
                             GridItem (btnCompare),
                             GridItem (btnLimiter),
+                            GridItem (cmbLookAhead),
                             GridItem (btnMute)
                         });
 
@@ -138,7 +182,7 @@ void MonitoringComponent::resized()
 float MonitoringComponent::getMinimumWidth()
 {
     // This is an arbitrary minimum that should look OK
-    return 400.0f;
+    return 850.0f;
 }
 float MonitoringComponent::getMinimumHeight()
 {
@@ -152,63 +196,21 @@ void MonitoringComponent::prepare (const dsp::ProcessSpec& spec)
     monitoringGain.prepare (spec);
     monitoringGain.setGainDecibels (static_cast<float> (sldGain.getValue()));
     sampleRate = spec.sampleRate;
-    limiterHoldTime = static_cast<float> (sampleRate) / 128.0f;
-    limiterReleaseTimer1 = 0.0f;
-    limiterReleaseTimer2 = limiterHoldTime / 2.0f;
-    limiterMax1 = 0.0f;
-    limiterMax2 = 0.0f;
-    limiterEnvelope = 0.0f;
-    limiterReleaseFactor = exp (-3.0f / (static_cast<float> (sampleRate) * jmax (limiterRelease, 0.05f)));
+    limiter.prepare (spec);
+    loudnessMeter.prepare (spec);
 }
 void MonitoringComponent::process (const dsp::ProcessContextReplacing<float>& context)
 {
-    if (!isMuted()) // Probably not necessary, because main component doesn't call MonitoringComponent::process if monitoring is muted anyway!
+    // Measure loudness even if monitoring is muted
+    loudnessMeter.process (context);
+
+    if (!isMuted())
     {
         // Apply gain
         monitoringGain.process (context);
 
         if (isLimited())
-        {
-            // Adapted from MGA JS Limiter - (C) Michael Gruhn 2008
-            for (auto i = 0; i < context.getInputBlock().getNumSamples(); ++i)
-            {               
-                // Get maximum sample across all channels at this sample index
-                float maxSample = context.getInputBlock().getSample (0, i);
-                for (auto ch = 1; ch < context.getInputBlock().getNumChannels(); ch++)
-                    maxSample = jmax (maxSample, context.getInputBlock().getSample (ch, i));
-
-                limiterReleaseTimer1 += 1.0f;
-                if (limiterReleaseTimer1 > limiterHoldTime)
-                {
-                    limiterReleaseTimer1 = 0.0f;
-                    limiterMax1 = 0.0f;
-                }
-                limiterMax1 = jmax (limiterMax1, maxSample);
-
-                limiterReleaseTimer2 += 1.0f;
-                if (limiterReleaseTimer2 > limiterHoldTime)
-                {
-                    limiterReleaseTimer2 = 0.0f;
-                    limiterMax2 = 0.0f;
-                }
-                limiterMax2 = jmax (limiterMax2, maxSample);
-
-                const float limiterMaxMax = jmax (limiterMax1, limiterMax2);
-                if (limiterEnvelope < limiterMaxMax)
-                    limiterEnvelope = limiterMaxMax;
-                else
-                    limiterEnvelope = limiterMaxMax + limiterReleaseFactor * (limiterEnvelope - limiterMaxMax);
-
-                float gain;
-                if (limiterEnvelope > limiterThreshold)
-                    gain = (limiterThreshold / limiterEnvelope) * limiterRange;
-                else
-                    gain = limiterRange;
-
-                for (auto ch = 0; ch < context.getOutputBlock().getNumChannels(); ch++)
-                    context.getOutputBlock().setSample(ch, i, context.getInputBlock().getSample (ch, i) * gain);
-            }
-        }
+            limiter.process (context);
     }
     else
         context.getOutputBlock().clear();
@@ -216,14 +218,33 @@ void MonitoringComponent::process (const dsp::ProcessContextReplacing<float>& co
 void MonitoringComponent::reset ()
 {
     monitoringGain.reset();
+    limiter.reset();
+    loudnessMeter.reset();
 }
 bool MonitoringComponent::isMuted() const
 {
     // For safe audio processing, we use local variable rather than accessing button toggle state
     return statusMute;
 }
+void MonitoringComponent::timerCallback()
+{
+    const auto txt = "M " + loudnessToString (loudnessMeter.getMomentaryLoudness())
+                   + "  S " + loudnessToString (loudnessMeter.getShortTermLoudness())
+                   + "  I " + loudnessToString (loudnessMeter.getIntegratedLoudness())
+                   + "  LRA " + String (loudnessMeter.getLoudnessRange(), 1)
+                   + (isLimited() ? "  GR " + String (limiter.readMaxGainReductionDb(), 1) : String());
+    lblLoudness.setText (txt, dontSendNotification);
+    btnLimiter.setTooltip (TRANS("Activate limiter on output") + " (using " + String (limiter.getCpuLoad() * 100.0, 2) + "% of the available processing time)");
+}
 bool MonitoringComponent::isLimited() const
 {
     // For safe audio processing, we use local variable rather than accessing button toggle state
     return statusLimiter;
 }
+String MonitoringComponent::loudnessToString (const float loudness) const
+{
+    // Anything below the absolute gate is treated as silence
+    if (loudness <= -70.0f)
+        return "-inf";
+    return String (loudness, 1);
+}
@@ -12,8 +12,10 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "ProcessorComponent.h"
+#include "../Processing/MeteringProcessors.h"
+#include "../Processing/LimiterProcessor.h"
 
-class MonitoringComponent final : public Component, public dsp::ProcessorBase
+class MonitoringComponent final : public Component, public dsp::ProcessorBase, public Timer
 {
 public:
 
@@ -31,6 +33,9 @@ public:
 
     bool isMuted() const;
 
+    // Updates the loudness readout
+    void timerCallback() override;
+
 private:
 
     AudioDeviceManager* deviceManager;
@@ -43,25 +48,26 @@ private:
     Slider sldGain;
     TextButton btnCompare;
     TextButton btnLimiter;
+    ComboBox cmbLookAhead;
     TextButton btnMute;
+    Label lblLoudness;
+    TextButton btnLoudnessReset;
 
     bool statusLimiter;
     bool statusMute;
     dsp::Gain<float> monitoringGain;
     double sampleRate{};
-    const float limiterCeiling = Decibels::decibelsToGain (-0.2f);      //  -6 .. 0 dB range
-    const float limiterThreshold = Decibels::decibelsToGain (-0.5f);    // -30 .. 0 dB range
-    const float limiterRange = limiterCeiling / limiterThreshold;
-    const float limiterRelease = 0.2f;                                  // 0.0 .. 0.5 range
-    float limiterHoldTime{};
-    float limiterReleaseTimer1{};
-    float limiterReleaseTimer2{};
-    float limiterMax1{};
-    float limiterMax2{};
-    float limiterEnvelope{};
-    float limiterReleaseFactor{};
+    const float limiterCeilingDb = -0.2f;       //  -6 .. 0 dB range
+    const float limiterThresholdDb = -0.5f;     // -30 .. 0 dB range
+    const float limiterRelease = 0.2f;          // 0.0 .. 0.5 range
+    int limiterLookAheadMs{};                   // Adds latency to the monitoring output
+    LimiterProcessor limiter;
+
+    // Loudness is measured before the monitoring gain and limiter (i.e. on the signal being tested)
+    LoudnessMeterProcessor loudnessMeter;
     
     bool isLimited() const;
+    String loudnessToString (const float loudness) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MonitoringComponent)
 };
\ No newline at end of file
@@ -29,13 +29,16 @@ Oscilloscope::Foreground::Foreground (Oscilloscope* parentOscilloscope)
 }
 void Oscilloscope::Foreground::paint (Graphics& g)
 {
-    parentScope->paintWaveform (g);
+    // The waveform is rendered on the render thread, so all we need to do here is draw the latest image and the cursor
+    parentScope->renderer.drawImage (g);
+    parentScope->paintCursor (g);
 }
 
 Oscilloscope::Oscilloscope ()
     :   background (this),
         foreground (this),
-        audioScopeProcessor (nullptr)
+        audioScopeProcessor (nullptr),
+        renderer (foreground)
 {
     this->setOpaque (true);
     this->setPaintingIsUnclipped (true);
@@ -51,20 +54,26 @@ Oscilloscope::Oscilloscope ()
 }
 Oscilloscope::~Oscilloscope ()
 {
+    // Stop rendering first so the render thread can't access anything while we're being destroyed
+    renderer.stop();
     masterReference.clear();
     // Remove listener callbacks so we don't leave anything hanging if we pop up an Oscilloscope then remove it
     if (removeListenerCallback) removeListenerCallback();
+    if (audioScopeProcessor != nullptr) audioScopeProcessor->removeStreamConsumer (streamConsumer);
 }
 void Oscilloscope::paint (Graphics&)
-{
-    for (auto ch = 0; ch < audioScopeProcessor->getNumChannels(); ++ch)
-        audioScopeProcessor->copyFrame (buffer.getWritePointer(ch), ch);
-}
+{ }
 void Oscilloscope::resized ()
 {
-    preCalculateVariables();
+    {
+        const ScopedLock sl (criticalSection);
+        plotWidth = getWidth();
+        plotHeight = getHeight();
+        preCalculateVariables();
+    }
     background.setBounds (getLocalBounds());
     foreground.setBounds (getLocalBounds());
+    renderer.setSize (getWidth(), getHeight());
 }
 void Oscilloscope::mouseDown (const MouseEvent&)
 {
@@ -74,29 +83,32 @@ void Oscilloscope::mouseDown (const MouseEvent&)
 void Oscilloscope::mouseDrag (const MouseEvent& event)
 {   
     // Pan according to horizontal mouse movement
+    const ScopedLock sl (criticalSection);
     const auto span = xMaxAtLastMouseDown - xMinAtLastMouseDown;
     const auto delta = event.getDistanceFromDragStartX() * span / getWidth();
     if (delta < 0)
     {
-        maxXSamples = jlimit (128, getMaximumBlockSize() - 1, xMaxAtLastMouseDown - delta);
+        maxXSamples = jlimit (128, getXLimit() - 1, xMaxAtLastMouseDown - delta);
         // Subtracting a negative delta means we are increasing minXSamples, in which case we don't have limit check it
         minXSamples = maxXSamples - span;
     }
     else if (delta > 0)
     {
-        minXSamples = jlimit (0, getMaximumBlockSize() - 128 - 1, xMinAtLastMouseDown - delta);
+        minXSamples = jlimit (0, getXLimit() - 128 - 1, xMinAtLastMouseDown - delta);
         // Subtracting a positive delta means we are decreasing maxXSamples, in which case we don't have limit check it
         maxXSamples = minXSamples + span;
     }
     background.repaint();
+    renderer.requestRender();
 
     // NOTE - vertical panning deliberately not implemented
 }
 void Oscilloscope::mouseDoubleClick (const MouseEvent& /*event*/)
 {
     // Reset default zoom
+    const ScopedLock sl (criticalSection);
     setXMin (0);
-    setXMax (defaultMaxXSamples);
+    setXMax (isCapturing() ? getXLimit() : defaultMaxXSamples);
     setMaxAmplitude (1.0f);
     preCalculateVariables();
     background.repaint();
@@ -128,6 +140,7 @@ void Oscilloscope::mouseWheelMove (const MouseEvent& event, const MouseWheelDeta
     if (ComponentPeer::getCurrentModifiersRealtime().isShiftDown())
     {
         // Zoom amplitude axis, centred about zero
+        const ScopedLock sl (criticalSection);
         const auto newAmplitudeDb = Decibels::gainToDecibels(getMaxAmplitude()) - wheel.deltaY * 2;
         const auto newAmplitude = Decibels::decibelsToGain (newAmplitudeDb, -150.0f);
         setMaxAmplitude (newAmplitude);
@@ -137,9 +150,13 @@ void Oscilloscope::mouseWheelMove (const MouseEvent& event, const MouseWheelDeta
     }
     else
     {
+        const ScopedLock sl (criticalSection);
+
         // Zoom x axis, centred on current position
-        const auto delta = static_cast<int> (wheel.deltaY * 100);
+        // Zoom in steps of ~100 samples for a single frame, scaled up for long captures
         const auto span = maxXSamples - minXSamples;
+        const auto stepScale = jmax (1.0f, static_cast<float> (span) / static_cast<float> (getMaximumBlockSize()));
+        const auto delta = static_cast<int> (wheel.deltaY * 100 * stepScale);
         const auto fraction = static_cast<float> (event.x) / static_cast<float> (getWidth());
         const auto zoomPos = getXMin() + static_cast<int> (static_cast<float> (span) * fraction);
         const auto newSpan = span - delta;
@@ -147,26 +164,26 @@ void Oscilloscope::mouseWheelMove (const MouseEvent& event, const MouseWheelDeta
         const auto newMaxX = newMinX + newSpan;
         if (newSpan < 128) // Limit max zoom so we don't go in closer than 128 samples
             return;
-        else if (newSpan >= getMaximumBlockSize())
+        else if (newSpan >= getXLimit())
         {
             minXSamples = 0;
-            maxXSamples = getMaximumBlockSize() - 1;
+            maxXSamples = getXLimit() - 1;
         }
         else
         {
-            if (newMinX >= 0 && newMinX < getMaximumBlockSize() - 128 && newMaxX >= 128 && newMaxX < getMaximumBlockSize())
+            if (newMinX >= 0 && newMinX < getXLimit() - 128 && newMaxX >= 128 && newMaxX < getXLimit())
             {
                 minXSamples = newMinX;
                 maxXSamples = newMaxX;               
             }
-            else if (newMinX < 0 && newSpan < getMaximumBlockSize())
+            else if (newMinX < 0 && newSpan < getXLimit())
             {
                 minXSamples = 0;
                 maxXSamples = newSpan;
             }
-            else if (newMaxX >= getMaximumBlockSize() && maxXSamples - newSpan >= 0)
+            else if (newMaxX >= getXLimit() && maxXSamples - newSpan >= 0)
             {
-                maxXSamples = getMaximumBlockSize();
+                maxXSamples = getXLimit();
                 minXSamples = maxXSamples - newSpan;
             }
         }
@@ -177,10 +194,11 @@ void Oscilloscope::mouseWheelMove (const MouseEvent& event, const MouseWheelDeta
 }
 void Oscilloscope::timerCallback()
 {
-    // Only repaint if a new data frame is ready (flag is set by a listener callback from the audio thread)
-    if (dataFrameReady.get())
+    // Captured data is drained from the stream on the render thread, so keep rendering while capturing
+    // Otherwise only render if a new data frame is ready (flag is set by a listener callback from the audio thread)
+    if (isCapturing() || dataFrameReady.get())
     {
-        repaint();
+        renderer.requestRender();
         dataFrameReady.set (false);
     }
 }
@@ -194,8 +212,14 @@ void Oscilloscope::assignAudioScopeProcessor (AudioScopeProcessor* audioScopePro
 void Oscilloscope::prepare()
 {
     jassert (audioScopeProcessor != nullptr); // audioScopeProcessor should be assigned & prepared first
-    buffer.setSize (audioScopeProcessor->getNumChannels(), audioScopeProcessor->getMaximumBlockSize());
-    preCalculateVariables();
+    {
+        const ScopedLock sl (criticalSection);
+        buffer.setSize (audioScopeProcessor->getNumChannels(), audioScopeProcessor->getMaximumBlockSize());
+        streamConsumer = -1; // Stream consumers are cleared when the processor is prepared
+        configureCapture();
+        preCalculateVariables();
+    }
+    renderer.start ([this] (Graphics& g) { return renderWaveform (g); });
     WeakReference<Oscilloscope> weakThis = this;
     removeListenerCallback = audioScopeProcessor->addListenerCallback ([this, weakThis]
     {
@@ -204,8 +228,13 @@ void Oscilloscope::prepare()
             dataFrameReady.set (true);
     });
 }
+void Oscilloscope::stopRendering()
+{
+    renderer.stop();
+}
 void Oscilloscope::setMaxAmplitude(const float maximumAmplitude)
 {
+    const ScopedLock sl (criticalSection);
     const auto minimum = Decibels::decibelsToGain(-100.0f, -150.0f);
     amplitudeMax = jlimit (minimum, 2.0f, maximumAmplitude);
     preCalculateVariables();
@@ -217,7 +246,8 @@ float Oscilloscope::getMaxAmplitude () const
 }
 void Oscilloscope::setXMin (const int minimumX)
 {
-    minXSamples = jlimit (0, audioScopeProcessor->getMaximumBlockSize() - 128, minimumX);
+    const ScopedLock sl (criticalSection);
+    minXSamples = jlimit (0, getXLimit() - 128, minimumX);
     preCalculateVariables();
     background.repaint();
 }
@@ -227,7 +257,8 @@ int Oscilloscope::getXMin() const
 }
 void Oscilloscope::setXMax (const int maximumX)
 {
-    maxXSamples = jlimit (128, audioScopeProcessor->getMaximumBlockSize(), maximumX);
+    const ScopedLock sl (criticalSection);
+    maxXSamples = jlimit (128, getXLimit(), maximumX);
     preCalculateVariables();
     background.repaint();
 }
@@ -249,17 +280,76 @@ Oscilloscope::AggregationMethod Oscilloscope::getAggregationMethod () const
 }
 void Oscilloscope::setAggregationMethod (const AggregationMethod method)
 {
+    const ScopedLock sl (criticalSection);
     aggregationMethod = method;
+    renderer.requestRender();
+}
+void Oscilloscope::setCaptureLengthSeconds (const double seconds)
+{
+    const ScopedLock sl (criticalSection);
+    captureLengthSeconds = jmax (0.0, seconds);
+    if (audioScopeProcessor != nullptr && audioScopeProcessor->getNumChannels() > 0)
+    {
+        configureCapture();
+
+        // Show the whole capture (or the default frame view)
+        minXSamples = 0;
+        maxXSamples = isCapturing() ? getXLimit() : defaultMaxXSamples;
+        preCalculateVariables();
+        background.repaint();
+        repaint();
+    }
+}
+double Oscilloscope::getCaptureLengthSeconds() const
+{
+    return captureLengthSeconds;
 }
 void Oscilloscope::setMouseMoveRepaintEnablement(const bool enableRepaints)
 {
     mouseMoveRepaintsEnabled = enableRepaints;
 }
+bool Oscilloscope::renderWaveform (Graphics& g)
+{
+    // Called on the render thread
+    const ScopedLock sl (criticalSection);
+    if (buffer.getNumChannels() == 0)
+        return false;
+
+    if (isCapturing())
+    {
+        drainCaptureStreams();
+    }
+    else
+    {
+        // All channels are aligned to the same trigger, so we only need the trigger position from the first
+        for (auto ch = 0; ch < buffer.getNumChannels(); ++ch)
+            audioScopeProcessor->copyFrame (buffer.getWritePointer (ch), ch, ch == 0 ? &triggerPosition : nullptr);
+    }
+    paintWaveform (g);
+    return true;
+}
 void Oscilloscope::paintWaveform (Graphics& g) const
 {
     // To speed things up we make sure we stay within the graphics context so we can disable clipping at the component level
-    
-    for (auto ch = 0; ch < audioScopeProcessor->getNumChannels(); ++ch)
+
+    if (isCapturing())
+        paintCapture (g);
+
+    // Shift triggered waveforms by the sub-sample trigger offset so the trigger point doesn't jitter by up to a sample
+    auto waveformTransform = AffineTransform();
+    if (! isCapturing() && triggerPosition >= 0.0f)
+    {
+        const auto triggerSample = std::floor (triggerPosition);
+        waveformTransform = AffineTransform::translation (-(triggerPosition - triggerSample) * xRatio, 0.0f);
+
+        const auto triggerPx = toPxFromTime (static_cast<int> (triggerSample));
+        g.setColour (Colours::white.withAlpha (0.3f));
+        g.drawVerticalLine (roundToInt (triggerPx), 0.0f, static_cast<float> (plotHeight));
+    }
+
+    // Paint the latest frame (unless we are displaying a capture)
+    const auto numFrameChannels = isCapturing() ? 0 : buffer.getNumChannels();
+    for (auto ch = 0; ch < numFrameChannels; ++ch)
     {
         auto* y = buffer.getReadPointer (ch);
 
@@ -268,14 +358,14 @@ void Oscilloscope::paintWaveform (Graphics& g) const
 
         // Draw a line representing the wave data for this channel
         Path p;
-        p.preallocateSpace ((getWidth() + 1) * 3);
+        p.preallocateSpace ((plotWidth + 1) * 3);
         p.startNewSubPath (0.0f, toPxFromAmp (y[minXSamples]));
 
         if (aggregationMethod == AggregationMethod::NearestSample)
         {
             // Iterate through pixels on x axis, plotting nearest sample
             auto lastXInSamples = -1;
-            for (auto xPx = 1; xPx < getWidth(); xPx++)
+            for (auto xPx = 1; xPx < plotWidth; xPx++)
             {
                 const auto xInSamples = toTimeFromPx (static_cast<float> (xPx));
                 // Avoid stair-casing by omitting points where x sample hasn't advanced from last pixel
@@ -331,9 +421,11 @@ void Oscilloscope::paintWaveform (Graphics& g) const
         }
         const auto pst = PathStrokeType (1.0f);
         g.setColour (getColourForChannel (ch));
-        g.strokePath(p, pst);
+        g.strokePath (p, pst, waveformTransform);
     }
-
+}
+void Oscilloscope::paintCursor (Graphics& g) const
+{
     // Output mouse co-ordinates in Hz/linear amplitude
     if (currentX >= 0 && currentY >= 0 && !isMouseButtonDown (true))
     {
@@ -362,6 +454,80 @@ void Oscilloscope::paintWaveform (Graphics& g) const
         g.drawText (txt, lblX, lblY, lblW, lblH, lblJust, false);
     }
 }
+void Oscilloscope::paintCapture (Graphics& g) const
+{
+    // Each pixel column is a range query on the pyramid, so the cost depends on the width rather than the number of samples shown
+    const auto captureStart = captureEnd - captureLengthSamples;
+    const auto samplesPerPixel = static_cast<float> (maxXSamples - minXSamples) / static_cast<float> (jmax (1, plotWidth));
+
+    for (auto ch = 0; ch < pyramids.size(); ++ch)
+    {
+        const auto* pyramid = pyramids[ch];
+        const auto oldest = pyramid->getOldestPosition();
+        const auto newest = pyramid->getNumSamplesWritten();
+        g.setColour (getColourForChannel (ch));
+
+        if (samplesPerPixel <= 1.0f)
+        {
+            // Zoomed in, so plot each sample
+            Path p;
+            p.preallocateSpace ((plotWidth + 1) * 3);
+            auto lastPosition = static_cast<int64> (-1);
+            for (auto xPx = 0; xPx < plotWidth; ++xPx)
+            {
+                const auto position = captureStart + toTimeFromPx (static_cast<float> (xPx));
+                if (position == lastPosition || position < oldest || position >= newest)
+                    continue;
+
+                const auto y = toPxFromAmp (pyramid->getSample (position));
+                if (p.isEmpty())
+                    p.startNewSubPath (static_cast<float> (xPx), y);
+                else
+                    p.lineTo (static_cast<float> (xPx), y);
+                lastPosition = position;
+            }
+            g.strokePath (p, PathStrokeType (1.0f));
+        }
+        else if (aggregationMethod == AggregationMethod::Average)
+        {
+            Path p;
+            p.preallocateSpace ((plotWidth + 1) * 3);
+            for (auto xPx = 0; xPx < plotWidth; ++xPx)
+            {
+                const auto start = captureStart + toTimeFromPx (static_cast<float> (xPx));
+                const auto end = captureStart + toTimeFromPx (static_cast<float> (xPx + 1));
+                if (end <= oldest || start >= newest)
+                    continue;
+
+                const auto y = toPxFromAmp (pyramid->getSummary (start, jmax (start + 1, end)).mean);
+                if (p.isEmpty())
+                    p.startNewSubPath (static_cast<float> (xPx), y);
+                else
+                    p.lineTo (static_cast<float> (xPx), y);
+            }
+            g.strokePath (p, PathStrokeType (1.0f));
+        }
+        else
+        {
+            // Draw the min/max envelope of each pixel column so that no peak is missed (also used for nearest sample when zoomed out)
+            RectangleList<float> envelope;
+            envelope.ensureStorageAllocated (plotWidth);
+            for (auto xPx = 0; xPx < plotWidth; ++xPx)
+            {
+                const auto start = captureStart + toTimeFromPx (static_cast<float> (xPx));
+                const auto end = captureStart + toTimeFromPx (static_cast<float> (xPx + 1));
+                if (end <= oldest || start >= newest)
+                    continue;
+
+                const auto summary = pyramid->getSummary (start, jmax (start + 1, end));
+                const auto top = toPxFromAmp (summary.max);
+                const auto bottom = toPxFromAmp (summary.min);
+                envelope.addWithoutMerging ({ static_cast<float> (xPx), top, 1.0f, jmax (1.0f, bottom - top) });
+            }
+            g.fillRectList (envelope);
+        }
+    }
+}
 void Oscilloscope::paintScale (Graphics& g) const
 {
     // To speed things up we make sure we stay within the graphics context so we can disable clipping at the component level
@@ -455,6 +621,61 @@ inline float Oscilloscope::toPxFromTime (const int xInSamples) const
 {
     return static_cast<float> (xInSamples - minXSamples) * xRatio;
 }
+bool Oscilloscope::isCapturing() const
+{
+    return captureLengthSamples > 0;
+}
+int Oscilloscope::getXLimit() const
+{
+    return isCapturing() ? captureLengthSamples : audioScopeProcessor->getMaximumBlockSize();
+}
+void Oscilloscope::configureCapture()
+{
+    audioScopeProcessor->removeStreamConsumer (streamConsumer);
+    streamConsumer = -1;
+    pyramids.clear();
+    captureLengthSamples = 0;
+    captureEnd = 0;
+
+    if (captureLengthSeconds > 0.0)
+    {
+        captureLengthSamples = roundToInt (captureLengthSeconds * audioScopeProcessor->getSampleRate());
+        for (auto ch = 0; ch < audioScopeProcessor->getNumChannels(); ++ch)
+            pyramids.add (new WaveformPyramid())->setCapacity (captureLengthSamples);
+        streamConsumer = audioScopeProcessor->addStreamConsumer();
+        if (streamConsumer < 0)
+        {
+            pyramids.clear();
+            captureLengthSamples = 0;
+        }
+    }
+
+    // Keep the current zoom if it still fits
+    minXSamples = jlimit (0, getXLimit() - 128, minXSamples);
+    maxXSamples = jlimit (minXSamples + 128, getXLimit(), maxXSamples);
+}
+bool Oscilloscope::drainCaptureStreams()
+{
+    auto drained = false;
+    for (auto ch = 0; ch < pyramids.size(); ++ch)
+    {
+        auto* pyramid = pyramids[ch];
+        const auto numSamples = audioScopeProcessor->drainStream (streamConsumer, ch, [pyramid] (const float* samples, const int num)
+        {
+            pyramid->append (samples, num);
+        });
+        drained = drained || numSamples > 0;
+    }
+
+    // Channels are drained one after the other, so only display up to the newest sample which all channels have
+    if (pyramids.size() > 0)
+    {
+        captureEnd = pyramids[0]->getNumSamplesWritten();
+        for (auto* pyramid : pyramids)
+            captureEnd = jmin (captureEnd, pyramid->getNumSamplesWritten());
+    }
+    return drained;
+}
 Colour Oscilloscope::getColourForChannel (const int channel)
 {
     switch (channel % 6)
@@ -470,8 +691,9 @@ Colour Oscilloscope::getColourForChannel (const int channel)
 }
 void Oscilloscope::preCalculateVariables()
 {
-    xRatio = static_cast<float> (getWidth()) / static_cast<float> (maxXSamples - minXSamples);
+    xRatio = static_cast<float> (plotWidth) / static_cast<float> (maxXSamples - minXSamples);
     xRatioInv = 1.0f / xRatio;
-    yRatio = static_cast<float> (getHeight()) / (amplitudeMax * 2.0f);
+    yRatio = static_cast<float> (plotHeight) / (amplitudeMax * 2.0f);
     yRatioInv = 1.0f / yRatio;
+    renderer.requestRender();
 }
@@ -11,6 +11,8 @@
 #pragma once
 
 #include "../Processing/AudioScopeProcessor.h"
+#include "../Processing/WaveformPyramid.h"
+#include "BackgroundRenderer.h"
 
 class Oscilloscope final : public Component, public Timer
 {
@@ -45,6 +47,9 @@ public:
     // Must be called after AudioScopeProcessor:prepare() so that the AudioProbe listeners can be set up properly
     void prepare();
 
+    // Must be called before AudioScopeProcessor:prepare() because the waveform is read on the render thread (prepare() restarts rendering)
+    void stopRendering();
+
     // Set maximum amplitude scale for y-axis (defaults to 1.0 otherwise)
     void setMaxAmplitude (const float maximumAmplitude);
     float getMaxAmplitude() const;
@@ -70,6 +75,12 @@ public:
     /** Set aggregation method for sub-pixel x values (otherwise initialised to maximum) */
     void setAggregationMethod (const AggregationMethod method);
 
+    /** Sets the length of signal history to display. With a length of zero, the latest (possibly triggered) frame is displayed.
+     *  Otherwise every frame is captured into a min/max pyramid and the display scrolls through the whole capture, which can be
+     *  zoomed all the way out without the repaint cost growing with the number of visible samples. */
+    void setCaptureLengthSeconds (const double seconds);
+    double getCaptureLengthSeconds() const;
+
     /** Allows mouse moves over this component to trigger repaints. This enables cursor co-ordinates to be painted even if audio has been suspended. */
     void setMouseMoveRepaintEnablement (const bool enableRepaints);
 
@@ -93,9 +104,17 @@ private:
         Oscilloscope* parentScope;
     };
 
+    bool renderWaveform (Graphics& g);
     void paintWaveform (Graphics& g) const;
+    void paintCapture (Graphics& g) const;
+    void paintCursor (Graphics& g) const;
     void paintScale (Graphics& g) const;
 
+    bool isCapturing() const;
+    int getXLimit() const;
+    void configureCapture();
+    bool drainCaptureStreams();
+
     inline float toAmpFromPx (const float yInPixels) const;
     inline float toPxFromAmp (const float amplitude) const;
     inline int toTimeFromPx (const float xInPixels) const;
@@ -115,6 +134,8 @@ private:
     float yRatio = 1.0f;
     float xRatioInv = 1.0f;
     float yRatioInv = 1.0f;
+    int plotWidth = 0;
+    int plotHeight = 0;
     int currentX = -1;
     int currentY = -1;
     AggregationMethod aggregationMethod = AggregationMethod::NearestSample;
@@ -125,6 +146,13 @@ private:
     const int defaultMaxXSamples = 2048 - 1;
 
     AudioBuffer<float> buffer;
+    float triggerPosition = -1.0f;
+
+    double captureLengthSeconds = 0.0;
+    int captureLengthSamples = 0;
+    int streamConsumer = -1;
+    int64 captureEnd = 0;
+    OwnedArray<WaveformPyramid> pyramids;
     CriticalSection criticalSection;
 
     ListenerRemovalCallback removeListenerCallback = {};
@@ -133,5 +161,8 @@ private:
 
     Atomic<bool> dataFrameReady;
 
+    // Renders the waveform on a worker thread (view state shared with the render thread is protected by criticalSection)
+    BackgroundRenderer renderer;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oscilloscope)
 };
\ No newline at end of file
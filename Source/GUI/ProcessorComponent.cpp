@@ -82,11 +82,27 @@ ProcessorComponent::ProcessorComponent (const String& processorId, ProcessorHarn
     btnMute.setToggleState (statusMute.get(), dontSendNotification);
     btnMute.onClick = [this] { statusMute = btnMute.getToggleState(); };
 
+    addAndMakeVisible (btnStress);
+    btnStress.setButtonText (TRANS("Stress"));
+    btnStress.setTooltip (TRANS("Run more and more instances of the processor until there's an xrun or the CPU load reaches ")
+                          + String (roundToInt (stressCpuThreshold * 100.0)) + "%, to find how many fit in real-time at the current device settings");
+    btnStress.setClickingTogglesState (true);
+    btnStress.setColour (TextButton::buttonOnColourId, Colours::darkorange);
+    btnStress.onClick = [this]
+    {
+        if (btnStress.getToggleState())
+            startStressTest();
+        else
+            stopStressTest ("it was cancelled");
+    };
+    stressInstances.reserve (static_cast<size_t> (maxStressInstances));
+
     if (!processor)
     {
         disableProcessor();
         muteProcessor();
         setEnabled (false);
+        btnStress.setEnabled (false);
     }
     else
     {
@@ -101,6 +117,9 @@ ProcessorComponent::ProcessorComponent (const String& processorId, ProcessorHarn
 }
 ProcessorComponent::~ProcessorComponent()
 {
+    stopTimer();
+    removeStressInstances();
+
     // Update configuration from class state
     config->setAttribute ("SourceA", statusSourceA.get());
     config->setAttribute ("SourceB", statusSourceB.get());
@@ -129,7 +148,7 @@ void ProcessorComponent::resized()
         Track (GUI_SIZE_PX(0.2)),   // Blank row
         Track (1_fr)                // Remainder used for viewport
     };
-    grid.templateColumns = { Track (GUI_SIZE_PX(3)), Track (GUI_SIZE_PX(1.5)), Track (1_fr), Track (GUI_SIZE_PX(1.8)), Track (GUI_SIZE_PX(1.8)), Track(GUI_BASE_GAP_PX), Track (GUI_SIZE_PX(2.2)), Track (GUI_SIZE_PX(2)), Track (GUI_SIZE_PX(1.7)) };
+    grid.templateColumns = { Track (GUI_SIZE_PX(3)), Track (GUI_SIZE_PX(1.5)), Track (1_fr), Track (GUI_SIZE_PX(1.8)), Track (GUI_SIZE_PX(1.8)), Track(GUI_BASE_GAP_PX), Track (GUI_SIZE_PX(2.2)), Track (GUI_SIZE_PX(2)), Track (GUI_SIZE_PX(1.7)), Track (GUI_SIZE_PX(1.8)) };
     grid.autoFlow = Grid::AutoFlow::row;
     grid.items.addArray({  
         GridItem (lblTitle).withArea ({}, GridItem::Span (2)),
@@ -140,8 +159,9 @@ void ProcessorComponent::resized()
         GridItem (btnDisable),
         GridItem (btnInvert),
         GridItem (btnMute),
-        GridItem().withArea ({}, GridItem::Span (9)), // Blank row
-        GridItem (viewport).withArea ({}, GridItem::Span (9))
+        GridItem (btnStress),
+        GridItem().withArea ({}, GridItem::Span (10)), // Blank row
+        GridItem (viewport).withArea ({}, GridItem::Span (10))
     });
 
     grid.performLayout (getLocalBounds().reduced (GUI_GAP_I(2), GUI_GAP_I(2)));
@@ -166,11 +186,20 @@ void ProcessorComponent::prepare (const dsp::ProcessSpec& spec)
 {
     if (processor)
         processor->prepareHarness (spec);
+
+    const SpinLock::ScopedLockType lock (stressLock);
+    stressSpec = spec;
+    stressBuffer = dsp::AudioBlock<float> (stressBufferMemory, spec.numChannels, spec.maximumBlockSize);
+    for (auto& instance : stressInstances)
+        instance->prepareHarness (spec);
 }
 void ProcessorComponent::process (const dsp::ProcessContextReplacing<float>& context)
 {
     if (processor)
+    {
+        processStressInstances (context.getOutputBlock());
         processor->processHarness (context);
+    }
     if (statusMute.get())
         context.getOutputBlock().clear();
 }
@@ -178,6 +207,10 @@ void ProcessorComponent::reset()
 {
     if (processor)
         processor->resetHarness();
+
+    const SpinLock::ScopedLockType lock (stressLock);
+    for (auto& instance : stressInstances)
+        instance->resetHarness();
 }
 bool ProcessorComponent::isSourceConnectedA() const noexcept
 {
@@ -212,6 +245,149 @@ void ProcessorComponent::disableProcessor (const bool shouldBeDisabled)
 {
     btnDisable.setToggleState (shouldBeDisabled, sendNotificationSync);
 }
+void ProcessorComponent::setDeviceManager (AudioDeviceManager* manager)
+{
+    deviceManager = manager;
+}
+void ProcessorComponent::timerCallback()
+{
+    auto* device = deviceManager->getCurrentAudioDevice();
+    if (device == nullptr || !device->isPlaying())
+    {
+        stopStressTest ("the audio device stopped");
+        return;
+    }
+    if (!isProcessorEnabled())
+    {
+        stopStressTest ("the processor was disabled");
+        return;
+    }
+    if (stressTicksToSettle > 0)
+    {
+        --stressTicksToSettle;
+        return;
+    }
+
+    const auto load = deviceManager->getCpuUsage();
+    const auto numInstances = 1 + static_cast<int> (stressInstances.size());
+    if (device->getXRunCount() > stressStartXRuns)
+    {
+        stopStressTest ("there was an xrun with " + String (numInstances) + " instances");
+        return;
+    }
+    if (load > stressCpuThreshold)
+    {
+        stopStressTest ("the CPU load reached " + String (roundToInt (load * 100.0)) + "% with " + String (numInstances) + " instances");
+        return;
+    }
+
+    stressSustainableCount = numInstances;
+    stressSustainableLoad = load;
+    if (numInstances > maxStressInstances)
+    {
+        stopStressTest ("the maximum number of instances was reached");
+        return;
+    }
+
+    // Add about 10% more at a time so that large counts are reached reasonably quickly
+    addStressInstances (jmin (jmax (1, numInstances / 10), maxStressInstances + 1 - numInstances));
+    btnStress.setButtonText ("x" + String (1 + static_cast<int> (stressInstances.size())));
+    stressTicksToSettle = stressSettleTicks;
+}
+void ProcessorComponent::startStressTest()
+{
+    auto* device = deviceManager != nullptr ? deviceManager->getCurrentAudioDevice() : nullptr;
+    auto problem = String();
+    if (device == nullptr || !device->isPlaying())
+        problem = "The audio device needs to be running.";
+    else if (!isProcessorEnabled())
+        problem = "The processor needs to be enabled.";
+    else if (!processor->createInstance())
+        problem = "The processor can't create more instances of itself (it needs to override ProcessorHarness::createInstance).";
+
+    if (problem.isNotEmpty())
+    {
+        btnStress.setToggleState (false, dontSendNotification);
+        AlertWindow::showMessageBoxAsync (AlertWindow::AlertIconType::WarningIcon, "Stress test", problem);
+        return;
+    }
+
+    stressStartXRuns = device->getXRunCount();
+    stressSustainableCount = 0;
+    stressSustainableLoad = 0.0;
+    stressTicksToSettle = stressSettleTicks;
+    btnStress.setButtonText ("x1");
+    startTimer (stressTimerInterval);
+}
+void ProcessorComponent::stopStressTest (const String& reason)
+{
+    stopTimer();
+    removeStressInstances();
+    btnStress.setToggleState (false, dontSendNotification);
+    btnStress.setButtonText (TRANS("Stress"));
+
+    auto message = String();
+    if (stressSustainableCount > 0)
+        message << stressSustainableCount << " instance" << (stressSustainableCount == 1 ? "" : "s") << " of " << processor->getProcessorName()
+                << " ran without problems at " << String (stressSpec.sampleRate, 0) << " Hz with " << static_cast<int> (stressSpec.maximumBlockSize)
+                << " sample blocks (CPU load " << roundToInt (stressSustainableLoad * 100.0) << "%).";
+    else
+        message << "Not even one instance of " << processor->getProcessorName() << " ran without problems.";
+    message << "\n\nStopped because " << reason << ".";
+    AlertWindow::showMessageBoxAsync (AlertWindow::AlertIconType::InfoIcon, "Stress test", message);
+}
+void ProcessorComponent::addStressInstances (const int numberToAdd)
+{
+    dsp::ProcessSpec spec {};
+    {
+        const SpinLock::ScopedLockType lock (stressLock);
+        spec = stressSpec;
+    }
+
+    for (auto n = 0; n < numberToAdd; ++n)
+    {
+        // Create and prepare the instance before taking the lock, so the audio thread only misses a block if it has to
+        auto instance = processor->createInstance();
+        if (!instance)
+            return;
+        for (auto i = 0; i < instance->getNumControls(); ++i)
+        {
+            instance->setControlValue (i, processor->getControlValue (i));
+            instance->setControlAutomation (i, processor->getControlAutomation (i));
+        }
+        instance->prepareHarness (spec);
+
+        const SpinLock::ScopedLockType lock (stressLock);
+        if (stressSpec.sampleRate != spec.sampleRate || stressSpec.maximumBlockSize != spec.maximumBlockSize || stressSpec.numChannels != spec.numChannels)
+            instance->prepareHarness (stressSpec);
+        stressInstances.push_back (std::move (instance));
+    }
+}
+void ProcessorComponent::removeStressInstances()
+{
+    // Destroy the instances outside the lock
+    std::vector<std::unique_ptr<ProcessorHarness>> removed;
+    {
+        const SpinLock::ScopedLockType lock (stressLock);
+        removed.swap (stressInstances);
+        stressInstances.reserve (static_cast<size_t> (maxStressInstances));
+    }
+}
+void ProcessorComponent::processStressInstances (const dsp::AudioBlock<float>& input)
+{
+    const SpinLock::ScopedTryLockType lock (stressLock);
+    if (!lock.isLocked() || stressInstances.empty())
+        return;
+
+    auto buffer = stressBuffer.getSubsetChannelBlock (0, input.getNumChannels()).getSubBlock (0, input.getNumSamples());
+    for (auto& instance : stressInstances)
+    {
+        for (auto i = 0; i < instance->getNumControls(); ++i)
+            instance->setControlValue (i, processor->getControlValue (i));
+        buffer.copyFrom (input);
+        instance->processHarness (dsp::ProcessContextReplacing<float> (buffer));
+    }
+}
 
 ProcessorComponent::ControlComponent::ControlComponent (const int index, ProcessorHarness* processorBeingControlled)
     : controlIndex (index),
@@ -242,6 +418,24 @@ ProcessorComponent::ControlComponent::ControlComponent (const int index, Process
     };
     sldControl.setValue (defaultControlValue, sendNotificationSync);
     addAndMakeVisible (sldControl);
+
+    btnAutomation.setButtonText ("~");
+    btnAutomation.setTooltip (TRANS("Automate this control with an LFO or breakpoint curve"));
+    btnAutomation.setColour (TextButton::buttonOnColourId, Colours::darkorange);
+    btnAutomation.onClick = [this, controlName]
+    {
+        if (!processor)
+            return;
+        automationPopup = std::make_unique<AutomationLanePopup> (controlName, processor->getControlAutomation (controlIndex), &btnAutomation);
+        automationPopup->onChange = [this] (const AutomationLane& lane)
+        {
+            processor->setControlAutomation (controlIndex, lane);
+            btnAutomation.setToggleState (lane.isActive(), dontSendNotification);
+        };
+        automationPopup->setOwner (&automationPopup);
+        automationPopup->show();
+    };
+    addAndMakeVisible (btnAutomation);
 }
 void ProcessorComponent::ControlComponent::paint (Graphics&)
 { }
@@ -255,11 +449,11 @@ void ProcessorComponent::ControlComponent::resized()
 
     grid.templateRows = { Track (GUI_BASE_SIZE_PX) };
     
-    grid.templateColumns = { Track (GUI_SIZE_PX (3)), Track (1_fr) };
+    grid.templateColumns = { Track (GUI_SIZE_PX (3)), Track (1_fr), Track (GUI_BASE_SIZE_PX) };
 
     grid.autoFlow = Grid::AutoFlow::row;
 
-    grid.items.addArray({ GridItem (lblControl), GridItem (sldControl) });
+    grid.items.addArray({ GridItem (lblControl), GridItem (sldControl), GridItem (btnAutomation) });
 
     grid.performLayout (getLocalBounds());
 }
@@ -305,3 +499,138 @@ void ProcessorComponent::ControlArrayComponent::initialiseControls()
     for (auto controlComponent : *controlComponents)
         addAndMakeVisible (controlComponent);
 }
+
+AutomationLanePopup::AutomationLanePopup (const String& controlName, const AutomationLane& initialLane, const Component* componentToPositionNear)
+    : lane (initialLane)
+{
+    addKeyListener (this);
+
+    lblTitle.setText ("Automate " + controlName, dontSendNotification);
+    lblTitle.setFont (Font (GUI_SIZE_F(0.6), Font::bold));
+    addAndMakeVisible (lblTitle);
+
+    lblShape.setText ("Shape", dontSendNotification);
+    addAndMakeVisible (lblShape);
+    cmbShape.addItemList (AutomationLane::getShapeNames(), 1);
+    cmbShape.setSelectedItemIndex (static_cast<int> (lane.shape), dontSendNotification);
+    cmbShape.onChange = [this] { updateLane(); };
+    addAndMakeVisible (cmbShape);
+
+    lblRate.setText ("Rate", dontSendNotification);
+    addAndMakeVisible (lblRate);
+    sldRate.setSliderStyle (Slider::LinearHorizontal);
+    sldRate.setTextBoxStyle (Slider::TextBoxRight, false, GUI_SIZE_I(2), GUI_SIZE_I(0.7));
+    sldRate.setRange (0.01, 50.0, 0.01);
+    sldRate.setSkewFactorFromMidPoint (2.0);
+    sldRate.setTextValueSuffix (" Hz");
+    sldRate.setValue (lane.rate, dontSendNotification);
+    sldRate.setTooltip (TRANS("Frequency of the LFO"));
+    sldRate.onValueChange = [this] { updateLane(); };
+    addAndMakeVisible (sldRate);
+
+    lblDepth.setText ("Depth", dontSendNotification);
+    addAndMakeVisible (lblDepth);
+    sldDepth.setSliderStyle (Slider::LinearHorizontal);
+    sldDepth.setTextBoxStyle (Slider::TextBoxRight, false, GUI_SIZE_I(2), GUI_SIZE_I(0.7));
+    sldDepth.setRange (0.0, 0.5, 0.001);
+    sldDepth.setValue (lane.depth, dontSendNotification);
+    sldDepth.setTooltip (TRANS("Deviation of the LFO either side of the control value"));
+    sldDepth.onValueChange = [this] { updateLane(); };
+    addAndMakeVisible (sldDepth);
+
+    lblBreakpoints.setText ("Points", dontSendNotification);
+    addAndMakeVisible (lblBreakpoints);
+    txtBreakpoints.setText (AutomationLane::breakpointsToString (lane.breakpoints), dontSendNotification);
+    txtBreakpoints.setTextToShowWhenEmpty ("0:0, 1:1, 2:0", Colours::grey);
+    txtBreakpoints.setTooltip (TRANS("Breakpoints as time (seconds) : value (0..1) pairs, looped at the time of the last point"));
+    txtBreakpoints.onTextChange = [this] { updateLane(); };
+    addAndMakeVisible (txtBreakpoints);
+
+    btnDone.setButtonText ("Done");
+    btnDone.setColour (TextButton::ColourIds::buttonColourId, Colours::green);
+    btnDone.onClick = [this] { dismiss(); };
+    addAndMakeVisible (btnDone);
+
+    updateEnablement();
+
+    // Size and position relative to anchor component
+    const auto popupWidth = GUI_SIZE_I (9);
+    const auto popupHeight = GUI_SIZE_I (6) + GUI_GAP_I (5) + GUI_GAP_I (4);
+    const auto anchorRight = componentToPositionNear->getScreenX() + componentToPositionNear->getWidth() + GUI_BASE_GAP_I;
+    const auto anchorTop = componentToPositionNear->getScreenY();
+    auto left = anchorRight;
+    auto top = anchorTop;
+    if (const auto* anchorDisplay = Desktop::getInstance().getDisplays().getDisplayForRect (componentToPositionNear->getScreenBounds()))
+    {
+        left = jmin (anchorRight, anchorDisplay->userArea.getRight() - popupWidth);
+        top = jmin (anchorTop, anchorDisplay->userArea.getBottom() - popupHeight);
+    }
+    setTopLeftPosition (left, top);
+    setSize (popupWidth, popupHeight);
+}
+void AutomationLanePopup::paint (Graphics& g)
+{
+    g.fillAll (DspTestBenchLnF::ApplicationColours::componentBackground());
+    g.setColour (DspTestBenchLnF::ApplicationColours::componentOutline());
+    g.drawRect (getLocalBounds());
+}
+void AutomationLanePopup::resized()
+{
+    using Track = Grid::TrackInfo;
+    Grid grid;
+    grid.rowGap = GUI_BASE_GAP_PX;
+    grid.columnGap = GUI_BASE_GAP_PX;
+    grid.templateRows = { Track (GUI_BASE_SIZE_PX), Track (GUI_BASE_SIZE_PX), Track (GUI_BASE_SIZE_PX), Track (GUI_BASE_SIZE_PX), Track (GUI_BASE_SIZE_PX), Track (GUI_BASE_SIZE_PX) };
+    grid.templateColumns = { Track (GUI_SIZE_PX (2)), Track (1_fr) };
+    grid.items.addArray ({
+            GridItem (lblTitle).withArea ({}, GridItem::Span (2)),
+            GridItem (lblShape), GridItem (cmbShape),
+            GridItem (lblRate), GridItem (sldRate),
+            GridItem (lblDepth), GridItem (sldDepth),
+            GridItem (lblBreakpoints), GridItem (txtBreakpoints),
+            GridItem(), GridItem (btnDone)
+        });
+    grid.performLayout (getLocalBounds().reduced (GUI_GAP_I(2), GUI_GAP_I(2)));
+}
+bool AutomationLanePopup::keyPressed (const KeyPress& key, Component* /*originatingComponent*/)
+{
+    if (key == KeyPress::escapeKey)
+    {
+        dismiss();
+        return true;
+    }
+    return false;
+}
+void AutomationLanePopup::show()
+{
+    setVisible (true);
+    addToDesktop (ComponentPeer::StyleFlags::windowIsTemporary | ComponentPeer::StyleFlags::windowHasDropShadow);
+    this->toFront (true);
+}
+void AutomationLanePopup::dismiss()
+{
+    this->removeFromDesktop();
+    if (myOwner)
+        myOwner->reset();
+}
+void AutomationLanePopup::setOwner (std::unique_ptr<AutomationLanePopup>* owner)
+{
+    myOwner = owner;
+}
+void AutomationLanePopup::updateLane()
+{
+    lane.shape = static_cast<AutomationLane::Shape> (jmax (0, cmbShape.getSelectedItemIndex()));
+    lane.rate = sldRate.getValue();
+    lane.depth = sldDepth.getValue();
+    lane.breakpoints = AutomationLane::parseBreakpoints (txtBreakpoints.getText());
+    updateEnablement();
+    if (onChange)
+        onChange (lane);
+}
+void AutomationLanePopup::updateEnablement()
+{
+    const auto isLfo = lane.isActive() && lane.shape != AutomationLane::Shape::breakpoints;
+    sldRate.setEnabled (isLfo);
+    sldDepth.setEnabled (isLfo);
+    txtBreakpoints.setEnabled (lane.shape == AutomationLane::Shape::breakpoints);
+}
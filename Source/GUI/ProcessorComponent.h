@@ -13,7 +13,9 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "../Processing/ProcessorHarness.h"
 
-class ProcessorComponent final : public Component, dsp::ProcessorBase
+class AutomationLanePopup;
+
+class ProcessorComponent final : public Component, dsp::ProcessorBase, private Timer
 {
 public:
     
@@ -36,9 +38,19 @@ public:
     void muteProcessor (const bool shouldBeMuted = true);
     void disableProcessor (const bool shouldBeDisabled = true);
 
+    /** Sets the device manager, which stress mode watches for CPU load and xruns (stress mode is unavailable without it). */
+    void setDeviceManager (AudioDeviceManager* manager);
+
     std::shared_ptr<ProcessorHarness> processor {};
 
 private:
+
+    void timerCallback() override;
+    void startStressTest();
+    void stopStressTest (const String& reason);
+    void addStressInstances (const int numberToAdd);
+    void removeStressInstances();
+    void processStressInstances (const dsp::AudioBlock<float>& input);
     
     class ControlComponent : public Component
     {
@@ -53,7 +65,9 @@ private:
         ProcessorHarness* processor;
         Label lblControl {};
         Slider sldControl {};
+        TextButton btnAutomation {};
         Atomic<double> currentControlValue;
+        std::unique_ptr<AutomationLanePopup> automationPopup {};
     };
 
     class ControlArrayComponent : public Component
@@ -81,6 +95,7 @@ private:
     TextButton btnDisable;
     TextButton btnInvert;
     TextButton btnMute;
+    TextButton btnStress;
 
     // TODO - add variable delay so that signals can be time aligned?
 
@@ -90,9 +105,62 @@ private:
     Atomic<bool> statusInvert = false;
     Atomic<bool> statusMute = false;
 
+    // Stress mode runs extra instances of the processor alongside it (each on a copy of its input, with the output discarded), adding
+    // more every few timer ticks until there's an xrun or the CPU load passes a threshold, to find how many fit in the real-time budget.
+    // Instances are added and removed on the message thread, and the audio thread skips them while the lock is held.
+    static constexpr int maxStressInstances = 256;
+    static constexpr double stressCpuThreshold = 0.8;
+    static constexpr int stressTimerInterval = 500;     // Milliseconds
+    static constexpr int stressSettleTicks = 2;         // Ticks to wait after adding instances (the CPU load is smoothed)
+
+    AudioDeviceManager* deviceManager = nullptr;
+    SpinLock stressLock;
+    std::vector<std::unique_ptr<ProcessorHarness>> stressInstances;
+    HeapBlock<char> stressBufferMemory {};
+    dsp::AudioBlock<float> stressBuffer;
+    dsp::ProcessSpec stressSpec {};
+    int stressTicksToSettle = 0;
+    int stressStartXRuns = 0;
+    int stressSustainableCount = 0;                     // Including the processor itself
+    double stressSustainableLoad = 0.0;
+
     Viewport viewport;
     OwnedArray<ControlComponent> controlArray {};
     ControlArrayComponent controlArrayComponent;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorComponent)
-};
\ No newline at end of file
+};
+
+/** A popup for editing the automation lane of a processor control, which is applied as it is edited. */
+class AutomationLanePopup : public Component, public KeyListener
+{
+public:
+    /** Creates an automation lane popup which you must call show() on. onChange is called with the lane whenever it is edited. */
+    AutomationLanePopup (const String& controlName, const AutomationLane& initialLane, const Component* componentToPositionNear);
+    ~AutomationLanePopup() override = default;
+
+    void paint (Graphics& g) override;
+    void resized() override;
+    bool keyPressed (const KeyPress& key, Component* originatingComponent) override;
+    void show();
+    void dismiss();
+    /** If you set the owner, then we'll delete ourselves when we finish. */
+    void setOwner (std::unique_ptr<AutomationLanePopup>* owner);
+
+    std::function<void (const AutomationLane&)> onChange;
+
+private:
+
+    void updateLane();
+    void updateEnablement();
+
+    AutomationLane lane;
+    Label lblTitle, lblShape, lblRate, lblDepth, lblBreakpoints;
+    ComboBox cmbShape;
+    Slider sldRate, sldDepth;
+    TextEditor txtBreakpoints;
+    TextButton btnDone;
+    std::unique_ptr<AutomationLanePopup>* myOwner = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomationLanePopup)
+};
@@ -48,6 +48,7 @@ SynthesisTab::SynthesisTab (String& sourceName)
         currentFrequency = sldFrequency.getValue();
         sweepStartFrequency = sldFrequency.getMinValue();
         sweepEndFrequency = sldFrequency.getMaxValue();
+        publishParameters();
     };
     sldFrequency.setMinAndMaxValues (config->getDoubleAttribute ("SweepMin", 10.0), config->getDoubleAttribute ("SweepMax", nyquist), dontSendNotification);
     sldFrequency.setValue (config->getDoubleAttribute ("Frequency", 440.0), sendNotificationSync);
@@ -67,7 +68,11 @@ SynthesisTab::SynthesisTab (String& sourceName)
     cmbSweepMode.setTooltip ("Select whether the frequency sweep wraps or reverses when it reaches its maximum value");
     cmbSweepMode.addItem ("Reverse", static_cast<int> (SweepMode::Reverse));
     cmbSweepMode.addItem ("Wrap", static_cast<int> (SweepMode::Wrap));
-    cmbSweepMode.onChange = [this] { currentSweepMode = static_cast<SweepMode> (cmbSweepMode.getSelectedId()); };
+    cmbSweepMode.onChange = [this]
+    {
+        currentSweepMode = static_cast<SweepMode> (cmbSweepMode.getSelectedId());
+        publishParameters();
+    };
     cmbSweepMode.setSelectedId (config->getIntAttribute ("SweepMode", static_cast<int> (SweepMode::Reverse)), sendNotificationSync);
 
     addAndMakeVisible (btnSweepEnabled);
@@ -247,55 +252,58 @@ void SynthesisTab::prepare (const dsp::ProcessSpec& spec)
 }
 void SynthesisTab::process (const dsp::ProcessContextReplacing<float>& context)
 {
-    if (isSelectedWaveformOscillatorBased())
+    const auto& params = parameters.acquire();
+
+    // Resets requested from the message thread are carried out here, so only the audio thread touches the generator state
+    if (params.resetGeneration != lastResetGeneration)
+    {
+        lastResetGeneration = params.resetGeneration;
+        resetGenerators (params);
+    }
+    if (params.sweepResetGeneration != lastSweepResetGeneration)
+    {
+        lastSweepResetGeneration = params.sweepResetGeneration;
+        sweepStepIndex = 0;
+        sweepStepDelta = 1;
+    }
+
+    if (isOscillatorBased (params.waveform))
     {
         // Set oscillator frequency
-        if (isSweepEnabled)
+        if (params.isSweepEnabled)
         {
+            const auto frequency = getSweepFrequency (params, sweepStepIndex);
+            sweepFrequency.set (frequency);
             for (auto&& oscillator : oscillators)
-                oscillator.setFrequency (static_cast<float> (getSweepFrequency()));
-            
-            if (currentSweepMode == SweepMode::Wrap)
-            {
-                if (sweepStepIndex >= numSweepSteps)
-                    sweepStepIndex = 0;
-                sweepStepIndex++;
-            }
-            else if (currentSweepMode == SweepMode::Reverse)
-            {
-                if (sweepStepIndex >= numSweepSteps)
-                    sweepStepDelta = -1;
-                else if (sweepStepIndex <= 0)
-                    sweepStepDelta = 1;
-                sweepStepIndex += sweepStepDelta;
-            }
+                oscillator.setFrequency (static_cast<float> (frequency));
+            advanceSweep (params, sweepStepIndex, sweepStepDelta);
         }
         else
         {
             for (auto&& oscillator : oscillators)
-                oscillator.setFrequency (static_cast<float> (currentFrequency));
+                oscillator.setFrequency (static_cast<float> (params.frequency));
         }
 
         // Process current oscillator (note we adjust 1-based index to 0-based index)
-        oscillators[static_cast<int> (currentWaveform) - 1].process (context);
+        oscillators[static_cast<int> (params.waveform) - 1].process (context);
         return;
     }
-    if (currentWaveform == Waveform::WhiteNoise)
+    if (params.waveform == Waveform::WhiteNoise)
     {
         whiteNoise.process (context);
         return;
     }
-    if (currentWaveform == Waveform::PinkNoise)
+    if (params.waveform == Waveform::PinkNoise)
     {
         pinkNoise.process (context);
         return;
     }
-    if (currentWaveform == Waveform::Impulse)
+    if (params.waveform == Waveform::Impulse)
     {
         impulseFunction.process (context);
         return;
     }
-    if (currentWaveform == Waveform::Step)
+    if (params.waveform == Waveform::Step)
     {
         stepFunction.process (context);
         return;
@@ -308,32 +316,121 @@ void SynthesisTab::reset()
     // Required to ensure synching with other source
     const ScopedLock sl (synthesiserCriticalSection);
 
-    for (auto&& oscillator : oscillators)
+    // The generators are reset by the audio thread at the start of its next block (see process())
+    ++resetGeneration;
+    resetSweep();
+}
+void SynthesisTab::render (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination)
+{
+    const auto blockSize = static_cast<size_t> (spec.maximumBlockSize);
+    jassert (destination.getNumSamples() % blockSize == 0);
+    destination.clear();
+
+    const auto renderBlocks = [&destination, blockSize] (auto& generator)
     {
-        oscillator.reset();
-        oscillator.setFrequency (static_cast<float> (currentFrequency), true);
-    }
+        for (size_t start = 0; start < destination.getNumSamples(); start += blockSize)
+        {
+            auto block = destination.getSubBlock (start, blockSize);
+            generator.process (dsp::ProcessContextReplacing<float> (block));
+        }
+    };
 
-    impulseFunction.reset();
-    stepFunction.reset();
-    resetSweep();
+    if (isSelectedWaveformOscillatorBased())
+    {
+        // Same order as the oscillators array
+        static constexpr dsp::PolyBlepOscillator<float>::PolyBlepWaveform oscillatorWaveforms[]
+        {
+            dsp::PolyBlepOscillator<float>::sine,
+            dsp::PolyBlepOscillator<float>::triangle,
+            dsp::PolyBlepOscillator<float>::square,
+            dsp::PolyBlepOscillator<float>::saw
+        };
+        dsp::PolyBlepOscillator<float> oscillator (oscillatorWaveforms[static_cast<int> (currentWaveform) - 1]);
+        oscillator.prepare (spec);
+
+        // The sweep takes the same time as it does live, but in steps of the rendered block size
+        Parameters sweepParameters;
+        sweepParameters.sweepStartFrequency = sweepStartFrequency;
+        sweepParameters.sweepEndFrequency = sweepEndFrequency;
+        sweepParameters.numSweepSteps = jmax (1L, static_cast<long> (sweepDuration * spec.sampleRate / static_cast<double> (blockSize)));
+        sweepParameters.sweepMode = currentSweepMode;
+        auto stepIndex = 0L;
+        auto stepDelta = 1;
+
+        oscillator.setFrequency (static_cast<float> (isSweepEnabled ? sweepStartFrequency : currentFrequency), true);
+        for (size_t start = 0; start < destination.getNumSamples(); start += blockSize)
+        {
+            if (isSweepEnabled)
+            {
+                oscillator.setFrequency (static_cast<float> (getSweepFrequency (sweepParameters, stepIndex)));
+                advanceSweep (sweepParameters, stepIndex, stepDelta);
+            }
+            auto block = destination.getSubBlock (start, blockSize);
+            oscillator.process (dsp::ProcessContextReplacing<float> (block));
+        }
+    }
+    else if (currentWaveform == Waveform::WhiteNoise)
+    {
+        dsp::WhiteNoiseGenerator noise;
+        renderBlocks (noise);
+    }
+    else if (currentWaveform == Waveform::PinkNoise)
+    {
+        dsp::PinkNoiseGenerator noise;
+        renderBlocks (noise);
+    }
+    else if (currentWaveform == Waveform::Impulse)
+    {
+        dsp::PulseFunctionBase<float> impulse;
+        impulse.setPreDelay (static_cast<size_t> (sldPreDelay.getValue()));
+        impulse.setPulseWidth (static_cast<size_t> (sldPulseWidth.getValue()));
+        impulse.setPositivePolarity (btnPulsePolarity.getToggleState());
+        impulse.prepare (spec);
+        renderBlocks (impulse);
+    }
+    else if (currentWaveform == Waveform::Step)
+    {
+        dsp::StepFunction<float> step;
+        step.setPreDelay (static_cast<size_t> (sldPreDelay.getValue()));
+        step.setPositivePolarity (btnPulsePolarity.getToggleState());
+        step.prepare (spec);
+        renderBlocks (step);
+    }
 }
 void SynthesisTab::timerCallback ()
 {
     jassert (isSweepEnabled);
-    sldFrequency.setValue (getSweepFrequency(), sendNotificationAsync);
+    sldFrequency.setValue (sweepFrequency.get(), sendNotificationAsync);
+}
+void SynthesisTab::publishParameters()
+{
+    Parameters newParameters;
+    newParameters.waveform = currentWaveform;
+    newParameters.frequency = currentFrequency;
+    newParameters.sweepStartFrequency = sweepStartFrequency;
+    newParameters.sweepEndFrequency = sweepEndFrequency;
+    newParameters.numSweepSteps = numSweepSteps;
+    newParameters.isSweepEnabled = isSweepEnabled;
+    newParameters.sweepMode = currentSweepMode;
+    newParameters.resetGeneration = resetGeneration;
+    newParameters.sweepResetGeneration = sweepResetGeneration;
+    parameters.publish (newParameters);
+}
+bool SynthesisTab::isOscillatorBased (const Waveform waveform)
+{
+    return (    waveform == Waveform::Sine 
+             || waveform == Waveform::Saw 
+             || waveform == Waveform::Square 
+             || waveform == Waveform::Triangle
+           );
 }
 bool SynthesisTab::isSelectedWaveformOscillatorBased() const
 {
-    return (    currentWaveform == Waveform::Sine 
-             || currentWaveform == Waveform::Saw 
-             || currentWaveform == Waveform::Square 
-             || currentWaveform == Waveform::Triangle
-           );
+    return isOscillatorBased (currentWaveform);
 }
 void SynthesisTab::waveformUpdated()
 {
-    // Store locally so audio routines can check value safely
+    // Store locally (the audio thread picks it up from the published parameters)
     currentWaveform = static_cast<Waveform> (cmbWaveform.getSelectedId());
 
     // Set control enablement based on waveform type
@@ -365,6 +462,8 @@ void SynthesisTab::waveformUpdated()
 
     // Trigger resized so we redraw the layout grid with different controls
     resized();
+
+    publishParameters();
 }
 void SynthesisTab::updateSweepEnablement ()
 {
@@ -376,26 +475,59 @@ void SynthesisTab::updateSweepEnablement ()
         startTimerHz (50);
     else
         stopTimer();
+
+    publishParameters();
 }
 void SynthesisTab::resetSweep()
 {
-    sweepStepIndex = 0;
-    sweepStepDelta = 1;
+    // The sweep is restarted by the audio thread at the start of its next block (see process())
+    ++sweepResetGeneration;
     if (isSweepEnabled)
         currentFrequency = sweepStartFrequency;
+    publishParameters();
+}
+void SynthesisTab::resetGenerators (const Parameters& generatorParameters)
+{
+    const auto frequency = generatorParameters.isSweepEnabled ? generatorParameters.sweepStartFrequency : generatorParameters.frequency;
+    for (auto&& oscillator : oscillators)
+    {
+        oscillator.reset();
+        oscillator.setFrequency (static_cast<float> (frequency), true);
+    }
+
+    impulseFunction.reset();
+    stepFunction.reset();
 }
-double SynthesisTab::getSweepFrequency() const
+double SynthesisTab::getSweepFrequency (const Parameters& sweepParameters, const long stepIndex)
 {
     //f(x) = 10^(log(span)/n*x) + fStart
     //where:
     //    x = the number of the sweep point
     //    n = total number of sweep points
-    const auto span = sweepEndFrequency - sweepStartFrequency;
-    return pow (10, log10 (span) / numSweepSteps * sweepStepIndex) + sweepStartFrequency;
+    const auto span = sweepParameters.sweepEndFrequency - sweepParameters.sweepStartFrequency;
+    return pow (10, log10 (span) / sweepParameters.numSweepSteps * stepIndex) + sweepParameters.sweepStartFrequency;
+}
+void SynthesisTab::advanceSweep (const Parameters& sweepParameters, long& stepIndex, int& stepDelta)
+{
+    if (sweepParameters.sweepMode == SweepMode::Wrap)
+    {
+        if (stepIndex >= sweepParameters.numSweepSteps)
+            stepIndex = 0;
+        stepIndex++;
+    }
+    else if (sweepParameters.sweepMode == SweepMode::Reverse)
+    {
+        if (stepIndex >= sweepParameters.numSweepSteps)
+            stepDelta = -1;
+        else if (stepIndex <= 0)
+            stepDelta = 1;
+        stepIndex += stepDelta;
+    }
 }
 void SynthesisTab::calculateNumSweepSteps()
 {
     numSweepSteps = static_cast<long> (sweepDuration * sampleRate / static_cast<double> (maxBlockSize));
+    publishParameters();
 }
 
 //SampleTab::SampleTab ()
@@ -743,6 +875,34 @@ bool WaveTab::getSnapshotMode() const
 {
     return playFromStartOnSnapshot;
 }
+void WaveTab::render (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination)
+{
+    const auto blockSize = static_cast<int> (spec.maximumBlockSize);
+    jassert (destination.getNumSamples() % static_cast<size_t> (blockSize) == 0);
+    destination.clear();
+
+    std::unique_ptr<AudioFormatReader> fileReader (formatManager.createReaderFor (audioThumbnailComponent->getCurrentFile()));
+    if (!fileReader)
+        return;
+
+    // Read through a transport source like the live player does, so the file is resampled in the same way (the source must outlive it)
+    const auto fileSampleRate = fileReader->sampleRate;
+    AudioFormatReaderSource fileSource (fileReader.release(), true);
+    fileSource.setLooping (btnLoop.getToggleState());
+    AudioTransportSource transport;
+    transport.setSource (&fileSource, 0, nullptr, fileSampleRate, static_cast<int> (spec.numChannels));
+    transport.prepareToPlay (blockSize, spec.sampleRate);
+    transport.start();
+
+    HeapBlock<float*> channels (destination.getNumChannels());
+    for (size_t ch = 0; ch < destination.getNumChannels(); ++ch)
+        channels[ch] = destination.getChannelPointer (ch);
+    AudioBuffer<float> buffer (channels, static_cast<int> (destination.getNumChannels()), static_cast<int> (destination.getNumSamples()));
+    for (auto start = 0; start < buffer.getNumSamples(); start += blockSize)
+        transport.getNextAudioBlock (AudioSourceChannelInfo (&buffer, start, blockSize));
+
+    transport.setSource (nullptr);
+}
 bool WaveTab::loadFile (const File& fileToPlay)
 {
     stop();
@@ -837,12 +997,11 @@ void WaveTab::stop()
     }
 }
 
-AudioTab::ChannelComponent::ChannelComponent (PeakMeterProcessor* meterProcessorToQuery, const int numberOfOutputChannels, const int channelIndex)
-    :   meterProcessor (meterProcessorToQuery),
-        numOutputs (numberOfOutputChannels),
+AudioTab::ChannelComponent::ChannelComponent (const int numberOfOutputChannels, const int channelIndex)
+    :   numOutputs (numberOfOutputChannels),
         channel (channelIndex)
 {
-    // Set opaque to reduce performance impact of meters redrawing
+    // Set opaque so that the meter bridge behind doesn't cause this to repaint
     this->setOpaque (true);
 
     // Initially map each input channel to the corresponding output channel (if it exists)
@@ -854,9 +1013,6 @@ AudioTab::ChannelComponent::ChannelComponent (PeakMeterProcessor* meterProcessor
     lblChannel.setFont (Font (GUI_SIZE_F(0.5)).boldened());
     addAndMakeVisible (lblChannel);
 
-    meterBar.setTooltip("Signal level for input channel " + String (channelIndex));
-    addAndMakeVisible (meterBar);
-
     sldGain.setSliderStyle (Slider::RotaryHorizontalVerticalDrag);
     sldGain.setTextBoxStyle (Slider::NoTextBox, false, 0, 0);
     sldGain.setRange (-100.0, 15.0, 1.0);
@@ -871,7 +1027,12 @@ AudioTab::ChannelComponent::ChannelComponent (PeakMeterProcessor* meterProcessor
     btnOutputSelection.setTriggeredOnMouseDown (true);
     btnOutputSelection.onClick  = [this] {
         channelSelectorPopup = std::make_unique<ChannelSelectorPopup> (numOutputs, "Output", selectedOutputChannels, &btnOutputSelection);
-        channelSelectorPopup->onClose = [this] (BigInteger& channelMask) { selectedOutputChannels = channelMask; };
+        channelSelectorPopup->onClose = [this] (BigInteger& channelMask)
+        {
+            selectedOutputChannels = channelMask;
+            if (onRoutingChanged)
+                onRoutingChanged();
+        };
         channelSelectorPopup->setOwner (&channelSelectorPopup);
         channelSelectorPopup->show();
     };
@@ -890,20 +1051,17 @@ void AudioTab::ChannelComponent::resized ()
     grid.rowGap = GUI_BASE_GAP_PX;
     grid.columnGap = GUI_BASE_GAP_PX;
     grid.templateRows = { Track (GUI_BASE_SIZE_PX), Track (GUI_SIZE_PX(0.75)), Track (1_fr) };
-    grid.templateColumns = { Track (GUI_SIZE_PX(0.6)), Track (GUI_SIZE_PX(1.4)) };
+    grid.templateColumns = { Track (GUI_SIZE_PX(1.4)) };
     grid.autoFlow = Grid::AutoFlow::column;
-    grid.items.addArray({   GridItem (meterBar).withArea (GridItem::Span (3), {}).withMargin(GridItem::Margin (0.0f, 2.0f, 0.0f, 0.0f)),
-                            GridItem (lblChannel), GridItem (btnOutputSelection), GridItem (sldGain)
-                        });
+    grid.items.addArray({ GridItem (lblChannel), GridItem (btnOutputSelection), GridItem (sldGain) });
     grid.performLayout (getLocalBounds().reduced (GUI_BASE_GAP_I, GUI_BASE_GAP_I));
 }
 float AudioTab::ChannelComponent::getMinimumWidth()
 {
     // This is an exact calculation of the width we want for a channel component
     const auto innerMargin = GUI_GAP_F(2);
-    const auto totalItemWidth = GUI_SIZE_F(2);
-    const auto totalItemGaps = GUI_BASE_GAP_F;
-    return innerMargin + totalItemWidth + totalItemGaps;
+    const auto totalItemWidth = GUI_SIZE_F(1.4);
+    return innerMargin + totalItemWidth;
 }
 float AudioTab::ChannelComponent::getMinimumHeight()
 {
@@ -920,12 +1078,10 @@ void AudioTab::ChannelComponent::sliderValueChanged (Slider* slider)
         const auto currentGain = static_cast<float> (sldGain.getValue());
         const auto minGain = static_cast<float> (sldGain.getMinimum());
         currentLinearGain = Decibels::decibelsToGain (currentGain, minGain);
+        if (onRoutingChanged)
+            onRoutingChanged();
     }
 }
-void AudioTab::ChannelComponent::setActive (bool shouldBeActive)
-{
-    active = shouldBeActive;
-}
 BigInteger AudioTab::ChannelComponent::getSelectedOutputs() const
 {
     return selectedOutputChannels;
@@ -938,50 +1094,69 @@ void AudioTab::ChannelComponent::reset()
 {
     sldGain.setValue(0.0, sendNotificationSync);
 }
-void AudioTab::ChannelComponent::refresh ()
-{
-    auto dB = -100.0f;
-    if (active)
-        dB = meterProcessor->getLevelDb (static_cast<int> (channel));
-    meterBar.setLevel (dB);
-}
 float AudioTab::ChannelComponent::getLinearGain() const
 {
     return currentLinearGain.get();
 }
 
-AudioTab::InputArrayComponent::InputArrayComponent (OwnedArray<ChannelComponent>* channelComponentsToReferTo)
-    : channelComponents (channelComponentsToReferTo)
-{ }
+AudioTab::InputArrayComponent::InputArrayComponent (OwnedArray<ChannelComponent>* channelComponentsToReferTo, MeterBridge* meterBridgeToLayOut)
+    : channelComponents (channelComponentsToReferTo),
+      meterBridge (meterBridgeToLayOut)
+{
+    // The meter bridge goes behind the channel components
+    addAndMakeVisible (meterBridge);
+}
 AudioTab::InputArrayComponent::~InputArrayComponent() = default;
-void AudioTab::InputArrayComponent::paint (Graphics&)
-{ }
-void AudioTab::InputArrayComponent::resized ()
+void AudioTab::InputArrayComponent::paint (Graphics& g)
 {
-    using Track = Grid::TrackInfo;
-    Grid grid;
-    grid.rowGap = GUI_BASE_GAP_PX;
-    grid.columnGap = GUI_BASE_GAP_PX;
-    grid.autoColumns = Track (Grid::Px (ChannelComponent::getMinimumWidth()));
-    grid.autoRows = Track (1_fr);
-    grid.autoFlow = Grid::AutoFlow::column;
+    // Background for each channel (the channel component covers all but the meter)
+    g.setColour (Colours::darkgrey.darker (0.3f));
     for (auto channelComponent : *channelComponents)
-        grid.items.add (GridItem (channelComponent));
-    grid.performLayout (getLocalBounds().reduced (GUI_BASE_GAP_I, GUI_BASE_GAP_I));
+        g.fillRect (channelComponent->getBounds().withTrimmedLeft (-(getMeterWidth() + GUI_BASE_GAP_I)));
+}
+void AudioTab::InputArrayComponent::resized ()
+{
+    meterBridge->setBounds (getLocalBounds());
+
+    auto area = getLocalBounds().reduced (GUI_BASE_GAP_I, GUI_BASE_GAP_I);
+    const auto channelWidth = static_cast<int> (getChannelWidth());
+    for (auto ch = 0; ch < channelComponents->size(); ++ch)
+    {
+        auto channelArea = area.removeFromLeft (channelWidth);
+        area.removeFromLeft (GUI_BASE_GAP_I);
+
+        // Leave a 2 pixel margin between the meter and the controls
+        const auto meterArea = channelArea.reduced (GUI_BASE_GAP_I).withWidth (getMeterWidth() - 2);
+        if (ch < meterBridge->getNumChannels())
+            meterBridge->setChannelBounds (ch, { meterArea, {}, {} });
+
+        (*channelComponents)[ch]->setBounds (channelArea.withTrimmedLeft (GUI_BASE_GAP_I + getMeterWidth()));
+    }
+}
+float AudioTab::InputArrayComponent::getChannelWidth()
+{
+    return GUI_BASE_GAP_F + static_cast<float> (getMeterWidth()) + ChannelComponent::getMinimumWidth();
+}
+int AudioTab::InputArrayComponent::getMeterWidth()
+{
+    return GUI_SIZE_I(0.6);
 }
 float AudioTab::InputArrayComponent::getMinimumWidth() const
 {
-    const auto channelWidth = ChannelComponent::getMinimumWidth();
-    const auto channelGap = GUI_BASE_GAP_I;    // Set in ChannelComponent resized()
+    const auto channelWidth = getChannelWidth();
+    const auto channelGap = GUI_BASE_GAP_I;    // Set in InputArrayComponent::resized()
     const auto margins = GUI_GAP_I(2);         // Set in InputArrayComponent::resized()
     const auto numIns = channelComponents->size();
     return numIns * channelWidth + jmax (0, numIns - 1) * channelGap + margins;
 }
 
 AudioTab::AudioTab (AudioDeviceManager* deviceManager)
-    : inputArrayComponent (&channelComponents),
+    : inputArrayComponent (&channelComponents, &meterBridge),
       audioDeviceManager (deviceManager)
 {
+    meterBridge.assignProcessors (&meterProcessor);
+    meterBridge.setChannelTooltip ("Signal level for input channel ");
+
     viewport.setScrollBarsShown (false, true);
     viewport.setViewedComponent (&inputArrayComponent);
     addAndMakeVisible (viewport);
@@ -1013,33 +1188,39 @@ void AudioTab::process (const dsp::ProcessContextReplacing<float>& context)
 {
     meterProcessor.process (context);
 
-    auto input = context.getInputBlock();
-    auto output = context.getOutputBlock();
-    auto temp = dsp::AudioBlock<float> (tempBuffer);
+    const auto& routes = routing.acquire();
+
+    const auto& input = context.getInputBlock();
+    const auto& output = context.getOutputBlock();
     const auto numInputChannels = static_cast<int> (input.getNumChannels());
     const auto numOutputChannels = static_cast<int> (output.getNumChannels());
+    const auto numSamples = static_cast<int> (input.getNumSamples());
+    jassert (numInputChannels <= tempBuffer.getNumChannels() && numSamples <= tempBuffer.getNumSamples());
 
-    // Apply gains to input channels
+    // Copy the inputs, as the output may be the same buffer
     for (auto ch = 0; ch < numInputChannels; ++ch)
-    {
-        auto linearGain = 0.0f;
-        if (channelComponents[ch] != nullptr)
-            linearGain = channelComponents[ch]->getLinearGain();
-        for (auto i = 0; i < input.getNumSamples(); ++i)
-            output.getChannelPointer (ch)[i] = input.getChannelPointer (ch)[i] * linearGain;
-    }
-    temp.copyFrom (input);
-    
-    // Add inputs to assigned outputs
-    output.clear();
+        tempBuffer.copyFrom (ch, 0, input.getChannelPointer (static_cast<size_t> (ch)), numSamples);
+
+    // The routes are sorted by output, so each output is set by its first route and accumulated by the rest
+    auto route = routes.cbegin();
     for (auto outCh = 0; outCh < numOutputChannels; ++outCh)
     {
-        for (auto inCh = 0; inCh < numInputChannels; ++inCh)
+        auto* dest = output.getChannelPointer (static_cast<size_t> (outCh));
+        auto isOutputSet = false;
+        for (; route != routes.cend() && route->output == outCh; ++route)
         {
-            auto outputChannel = output.getSingleChannelBlock (outCh);
-            if (channelComponents[inCh] != nullptr && channelComponents[inCh]->isOutputSelected (outCh))
-                outputChannel.add(temp.getSingleChannelBlock(inCh));
+            if (route->input >= numInputChannels)
+                continue;
+
+            const auto* src = tempBuffer.getReadPointer (route->input);
+            if (isOutputSet)
+                FloatVectorOperations::addWithMultiply (dest, src, route->gain, numSamples);
+            else
+                FloatVectorOperations::multiply (dest, src, route->gain, numSamples);
+            isOutputSet = true;
         }
+        if (!isOutputSet)
+            FloatVectorOperations::clear (dest, numSamples);
     }
 }
 void AudioTab::reset ()
@@ -1051,8 +1232,7 @@ void AudioTab::reset ()
 }
 void AudioTab::timerCallback ()
 {
-    for (auto ch : channelComponents)
-        ch->refresh();
+    meterBridge.refresh();
 }
 void AudioTab::channelsChanged()
 {
@@ -1068,41 +1248,59 @@ void AudioTab::channelsChanged()
         numInputs = static_cast<int> (numInputChannels);
         numOutputs = static_cast<int> (numOutputChannels);
 
-        inputArrayComponent.removeAllChildren();
         channelComponents.clear();
 
         for (auto ch  = 0; ch < numInputs; ++ ch)
-            inputArrayComponent.addAndMakeVisible (channelComponents.add (new ChannelComponent (&meterProcessor, numOutputChannels, ch)));
-            
+        {
+            inputArrayComponent.addAndMakeVisible (channelComponents.add (new ChannelComponent (numOutputChannels, ch)));
+            channelComponents.getLast()->onRoutingChanged = [this] { updateRouting(); };
+        }
+
         // Use this code to test the case where there are more channels that can fit within the parent
         //for (auto ch = numInputs; ch < 32; ++ ch)
-        //    inputArrayComponent.addAndMakeVisible (channelComponents.add (new ChannelComponent (&meterProcessor, numOutputChannels, ch)));
+        //    inputArrayComponent.addAndMakeVisible (channelComponents.add (new ChannelComponent (numOutputChannels, ch)));
+
+        meterBridge.setNumChannels (channelComponents.size());
+        updateRouting();
 
         const auto viewWidth = inputArrayComponent.getMinimumWidth();
         auto viewHeight = getHeight();
         if (viewWidth>getWidth())
             viewHeight -= viewport.getLookAndFeel().getDefaultScrollbarWidth();
         inputArrayComponent.setSize (static_cast<int> (viewWidth), static_cast<int> (viewHeight));
-        
+
+        // setSize() won't lay out the array if its size hasn't changed, but the new channels (and meters) still need bounds
+        inputArrayComponent.resized();
         resized();
     }
 }
+void AudioTab::updateRouting()
+{
+    std::vector<Route> newRoutes;
+    for (auto outCh = 0; outCh < numOutputs; ++outCh)
+    {
+        for (auto inCh = 0; inCh < channelComponents.size(); ++inCh)
+        {
+            const auto gain = channelComponents[inCh]->getLinearGain();
+            if (gain != 0.0f && channelComponents[inCh]->isOutputSelected (outCh))
+                newRoutes.push_back ({ inCh, outCh, gain });
+        }
+    }
+
+    routing.publish (newRoutes);
+}
 void AudioTab::setRefresh (const bool shouldRefresh)
 {
     if (shouldRefresh)
     {
-        for (auto ch : channelComponents)
-            ch->setActive (true);
+        meterBridge.setActive (true);
         startTimerHz (50);
     }
     else
     {
         stopTimer();
-        for (auto ch : channelComponents)
-        {
-            ch->setActive (false);
-            ch->refresh();
-        }
+        meterBridge.setActive (false);
+        meterBridge.refresh();
     }
 }
 
@@ -1169,7 +1367,11 @@ SourceComponent::SourceComponent (const String& sourceId, AudioDeviceManager* de
             }
         }
         channelSelectorPopup = std::make_unique<ChannelSelectorPopup> (numOutputs, "Output", selectedOutputChannels, &btnOutputSelection);
-        channelSelectorPopup->onClose = [this] (BigInteger& channelMask) { selectedOutputChannels = channelMask; };
+        channelSelectorPopup->onClose = [this] (BigInteger& channelMask)
+        {
+            selectedOutputChannels = channelMask;
+            publishParameters();
+        };
         channelSelectorPopup->setOwner (&channelSelectorPopup);
         channelSelectorPopup->show();
     };
@@ -1180,7 +1382,11 @@ SourceComponent::SourceComponent (const String& sourceId, AudioDeviceManager* de
     btnInvert.setColour (TextButton::buttonOnColourId, Colours::green);
     isInverted = config->getBoolAttribute ("Invert");
     btnInvert.setToggleState (isInverted, dontSendNotification);
-    btnInvert.onClick = [this] { isInverted = btnInvert.getToggleState(); };
+    btnInvert.onClick = [this]
+    {
+        isInverted = btnInvert.getToggleState();
+        publishParameters();
+    };
 
     addAndMakeVisible (btnMute);
     btnMute.setButtonText (TRANS("Mute"));
@@ -1191,6 +1397,7 @@ SourceComponent::SourceComponent (const String& sourceId, AudioDeviceManager* de
     btnMute.onClick = [this] {
         isMuted = btnMute.getToggleState();
         audioTab->setRefresh (!isMuted);
+        publishParameters();
     };
 
     tabbedComponent = std::make_unique<TabbedComponent> (TabbedButtonBar::TabsAtTop);
@@ -1207,6 +1414,7 @@ SourceComponent::SourceComponent (const String& sourceId, AudioDeviceManager* de
     tabbedComponent->addTab (TRANS("Audio In"), Colours::darkgrey, audioTab.get(), false, Mode::AudioIn);
     tabbedComponent->getTabbedButtonBar().addChangeListener(this);
     tabbedComponent->setCurrentTabIndex (config->getIntAttribute("TabIndex")); // Need to set tab after change listener added
+    publishParameters();
 }
 SourceComponent::~SourceComponent()
 {
@@ -1267,6 +1475,7 @@ void SourceComponent::changeListenerCallback (ChangeBroadcaster* source)
     {
         const auto shouldRefresh = tabbedComponent->getCurrentTabIndex() == Mode::AudioIn;
         audioTab->setRefresh (shouldRefresh);
+        publishParameters();
     }
 }
 void SourceComponent::prepare (const dsp::ProcessSpec& spec)
@@ -1280,11 +1489,12 @@ void SourceComponent::prepare (const dsp::ProcessSpec& spec)
 }
 void SourceComponent::process (const dsp::ProcessContextReplacing<float>& context)
 {
-    if (!isMuted)
+    const auto& params = parameters.acquire();
+
+    if (!params.isMuted)
     {
         // Process currently selected source
-        const auto idx = static_cast<Mode> (tabbedComponent->getCurrentTabIndex()); // this should be safe to call from an audio routine
-        switch (idx) {
+        switch (params.mode) {
             case Synthesis:  // NOLINT(bugprone-branch-clone)
                 synthesisTab->process (context);
                 break;
@@ -1303,13 +1513,13 @@ void SourceComponent::process (const dsp::ProcessContextReplacing<float>& contex
         // Apply gain
         gain.process (context);
 
-        if (isInverted)
+        if (params.isInverted)
             context.getOutputBlock().multiplyBy (-1.0f);
 
         // Mute disabled output channels
-        for (auto ch = 0; ch < numOutputs; ++ch)
+        for (auto ch = 0; ch < params.numOutputs; ++ch)
         {
-            if (!selectedOutputChannels[ch])
+            if (!params.selectedOutputChannels[ch])
             {
                 context.getOutputBlock().getSingleChannelBlock (static_cast<size_t> (ch)).clear();
             }
@@ -1338,10 +1548,47 @@ void SourceComponent::prepForSnapShot()
     audioTab->reset();
     gain.reset();
 }
-SourceComponent::Mode SourceComponent::getMode() const
+void SourceComponent::render (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination)
+{
+    destination.clear();
+    if (isMuted)
+        return;
+
+    switch (static_cast<Mode> (tabbedComponent->getCurrentTabIndex()))
+    {
+        case Synthesis:
+            synthesisTab->render (spec, destination);
+            break;
+        case WaveFile:
+            waveTab->render (spec, destination);
+            break;
+        case AudioIn:
+        default: ; // Leave silent
+    }
+
+    // Apply gain and inversion, and mute disabled output channels
+    const auto gainFactor = Decibels::decibelsToGain (static_cast<float> (sldGain.getValue())) * (isInverted ? -1.0f : 1.0f);
+    destination.multiplyBy (gainFactor);
+    for (auto ch = 0; ch < jmin (numOutputs, static_cast<int> (destination.getNumChannels())); ++ch)
+    {
+        if (!selectedOutputChannels[ch])
+            destination.getSingleChannelBlock (static_cast<size_t> (ch)).clear();
+    }
+}
+SourceComponent::Mode SourceComponent::getMode()
+{
+    // Picks up the latest parameters, which process() will then use for the same block
+    return parameters.acquire().mode;
+}
+void SourceComponent::publishParameters()
 {
-    // This is just looking up a local variable inside the tabbed component, so should be safe enough for audio processing
-    return static_cast<Mode> (tabbedComponent->getCurrentTabIndex());
+    Parameters newParameters;
+    newParameters.mode = static_cast<Mode> (tabbedComponent->getCurrentTabIndex());
+    newParameters.isInverted = isInverted;
+    newParameters.isMuted = isMuted;
+    newParameters.selectedOutputChannels = selectedOutputChannels;
+    newParameters.numOutputs = numOutputs;
+    parameters.publish (newParameters);
 }
 void SourceComponent::setOtherSource (SourceComponent* otherSourceComponent)
 {
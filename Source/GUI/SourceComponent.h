@@ -16,6 +16,7 @@
 #include "../Processing/PulseFunctions.h"
 #include "../Processing/NoiseGenerators.h"
 #include "../Processing/MeteringProcessors.h"
+#include "../Processing/AudioDataTransfer.h"
 
 // Forward declarations
 class SourceComponent;
@@ -62,6 +63,10 @@ public:
     void reset() override;    
     void timerCallback() override;
 
+    /** Renders the selected waveform into the destination (a whole number of blocks of spec.maximumBlockSize) using new generators set
+     *  up like the live ones, so the live ones are left untouched. A sweep starts from the beginning. Call this from the message thread. */
+    void render (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination);
+
 private:
 
     String keyName;
@@ -80,14 +85,34 @@ private:
     Slider sldPulseWidth;
     TextButton btnPulsePolarity;
     
+    // Settings read by the audio thread
+    struct Parameters
+    {
+        Waveform waveform = Waveform::Sine;
+        double frequency = 0.0;
+        double sweepStartFrequency = 0.0;
+        double sweepEndFrequency = 0.0;
+        long numSweepSteps = 0;
+        bool isSweepEnabled = false;
+        SweepMode sweepMode = SweepMode::Wrap;
+        uint32 resetGeneration = 0;         // Incremented to have the audio thread reset the generators
+        uint32 sweepResetGeneration = 0;    // Incremented to have the audio thread restart the sweep
+    };
+
     SourceComponent* otherSource {};
     CriticalSection synthesiserCriticalSection;
+    ParameterSnapshot<Parameters> parameters {};
+    Atomic<double> sweepFrequency = 0.0;    // Current frequency of the sweep, for display
     Waveform currentWaveform = Waveform::Sine;
     double sampleRate = 0.0;
     uint32 maxBlockSize = 0;
     long numSweepSteps = 0;
-    long sweepStepIndex = 0;
+    long sweepStepIndex = 0;                // Sweep state is only accessed by the audio thread
     int sweepStepDelta = 1;
+    uint32 resetGeneration = 0;
+    uint32 sweepResetGeneration = 0;
+    uint32 lastResetGeneration = 0;         // Last generations seen by the audio thread
+    uint32 lastSweepResetGeneration = 0;
     double currentFrequency = 0.0;
     double sweepStartFrequency = 0.0;
     double sweepEndFrequency = 0.0;
@@ -95,11 +120,15 @@ private:
     bool isSweepEnabled = false;
     SweepMode currentSweepMode = SweepMode::Wrap;
 
+    void publishParameters();
+    static bool isOscillatorBased (const Waveform waveform);
     bool isSelectedWaveformOscillatorBased() const;
     void waveformUpdated();
     void updateSweepEnablement();
     void resetSweep();
-    double getSweepFrequency() const;
+    void resetGenerators (const Parameters& generatorParameters);
+    static double getSweepFrequency (const Parameters& sweepParameters, const long stepIndex);
+    static void advanceSweep (const Parameters& sweepParameters, long& stepIndex, int& stepDelta);
     void calculateNumSweepSteps();
 
     dsp::PolyBlepOscillator<float> oscillators[4]
@@ -166,6 +195,10 @@ public:
     void setSnapshotMode (const bool shouldPlayFromStart);
     bool getSnapshotMode() const;
 
+    /** Renders the loaded file from the start into the destination (a whole number of blocks of spec.maximumBlockSize) with a new
+     *  reader, so the live playhead isn't moved. Call this from the message thread. */
+    void render (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination);
+
     class AudioThumbnailComponent : public Component,
                                     public FileDragAndDropTarget,
                                     public ChangeBroadcaster,
@@ -275,7 +308,7 @@ private:
     class ChannelComponent final : public Component, public Slider::Listener
     {
     public:
-        ChannelComponent (PeakMeterProcessor* meterProcessorToQuery, const int numberOfOutputChannels, const int channelIndex);;
+        ChannelComponent (const int numberOfOutputChannels, const int channelIndex);
         ~ChannelComponent() override;
 
         void paint (Graphics& g) override;
@@ -285,24 +318,21 @@ private:
 
         void sliderValueChanged (Slider* slider) override;
 
-        void setActive (bool shouldBeActive);
         BigInteger getSelectedOutputs() const;
         bool isOutputSelected (const int channelNumber) const;
         // Resets
         void reset();
-        // Queries meter processor to update meter value
-        void refresh();
         float getLinearGain() const;
 
+        // Called on the message thread when the gain or output selection changes
+        std::function<void()> onRoutingChanged;
+
     private:
 
         Label lblChannel;
-        MeterBar meterBar{};
         Slider sldGain;
         TextButton btnOutputSelection;
 
-        bool active = true;
-        PeakMeterProcessor* meterProcessor;
         int numOutputs = 0;
         BigInteger selectedOutputChannels = 0;
         int channel = 0;
@@ -315,7 +345,7 @@ private:
     class InputArrayComponent final : public Component
     {
     public:
-        explicit InputArrayComponent (OwnedArray<ChannelComponent>* channelComponentsToReferTo);
+        InputArrayComponent (OwnedArray<ChannelComponent>* channelComponentsToReferTo, MeterBridge* meterBridgeToLayOut);
         ~InputArrayComponent() override;
 
         void paint (Graphics& g) override;
@@ -323,16 +353,33 @@ private:
         float getMinimumWidth() const;
 
     private:
+        // Each channel has a meter (drawn by the meter bridge, behind the channel components) to the left of its controls
+        static float getChannelWidth();
+        static int getMeterWidth();
+
         OwnedArray<ChannelComponent>* channelComponents {};
+        MeterBridge* meterBridge {};
+    };
+
+    // A non-zero gain from an input channel to an output channel
+    struct Route
+    {
+        int input;
+        int output;
+        float gain;
     };
 
     void channelsChanged();
+    // Compiles the channel settings into a list of routes (sorted by output) and publishes it to the audio thread
+    void updateRouting();
 
     PeakMeterProcessor meterProcessor;
     Viewport viewport;
     OwnedArray <ChannelComponent> channelComponents {};
+    MeterBridge meterBridge {};
     InputArrayComponent inputArrayComponent;
     AudioBuffer<float> tempBuffer;
+    ParameterSnapshot<std::vector<Route>> routing {};
     AudioDeviceManager* audioDeviceManager;
     int numInputs = 0;
     int numOutputs = 0;
@@ -370,7 +417,13 @@ public:
     void storeWavePlayerState() const;
     void prepForSnapShot();
 
-    Mode getMode() const;
+    /** Renders consecutive blocks into the destination (whose length must be a whole number of blocks) at the given ProcessSpec, with
+     *  the current settings but separate generators, so the live source keeps running undisturbed. Audio input can't be rendered ahead
+     *  of time, so it renders silence. Call this from the message thread. */
+    void render (const dsp::ProcessSpec& spec, const dsp::AudioBlock<float>& destination);
+
+    // Gets the mode for the next block to be processed (call this on the audio thread)
+    Mode getMode();
     void setOtherSource (SourceComponent* otherSourceComponent);
     SynthesisTab* getSynthesisTab() const;
     void mute();
@@ -396,11 +449,23 @@ private:
     std::unique_ptr<AudioTab> audioTab{};
     std::unique_ptr<ChannelSelectorPopup> channelSelectorPopup {};
 
+    // Settings read by the audio thread
+    struct Parameters
+    {
+        Mode mode = Synthesis;
+        bool isInverted = false;
+        bool isMuted = false;
+        BigInteger selectedOutputChannels = 0;
+        int numOutputs = -1;
+    };
+    void publishParameters();
+
     SourceComponent* otherSource = nullptr;
     bool isInverted = false;
     bool isMuted = false;
     BigInteger selectedOutputChannels = 0;
     int numOutputs = -1;
+    ParameterSnapshot<Parameters> parameters {};
     
     dsp::Gain<float> gain;
 
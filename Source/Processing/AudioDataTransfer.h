@@ -11,7 +11,8 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
-#include <list>
+#include <atomic>
+#include <type_traits>
 
 /*  
 	This file contains utility classes designed for data transfer applications involving real time audio.
@@ -22,14 +23,17 @@
 		- AudioProcessor makes latest data available for GUI (AudioProbe)
 			- GUI polls probe when it feels like
 			- GUI is notified when there has been a change
-		-	AudioProcessor streams all data to GUI (AudioProcessorStreamingProbe, not provided)
-			-	Can't see where this would be needed except something like AutoTune's graph - normally you'd process everything you need
-				in the AudioProcessor and let the GUI sample what it needs
-			-	Would require a separate queue for each observer
+		-	AudioProcessor streams all data to GUI or another thread (AudioStreamingProbe)
+			-	Normally you'd process everything you need in the AudioProcessor and let the GUI sample what it needs, but recorders,
+				measurement engines and file writers need every frame
+			-	Each observer has it's own read cursor into a shared ring, the writer drops (and counts) frames rather than blocking
 		- Trivial cases
 			- Atomic data types
 	-	AudioProcessor to Processing Thread
 		-	Not recommended for plugins (you can miss the cache and the host will be trying to spread lots of plugins across cores anyhow)
+	-	GUI to AudioProcessor
+		-	GUI publishes an immutable snapshot of its parameters whenever they change, and the AudioProcessor picks up the latest
+			one at the start of each block (ParameterSnapshot), so every decision within a block is made from one consistent set
 	
 	Synchronous use cases:
 	---------------------
@@ -44,7 +48,8 @@
 	- Single writer is assumed (i.e. in AudioProcessor)
 	- Multiple observers/listeners assumed (need to be able to handle zero or more AudioProcessorEditors)
 	- Don't need to copy data in (as write index doesn't need to be advanced until ready)
-	- Need to copy out data in blocks (don't allow pointers or references as this may result in data tearing if accessing routines iterate slowly)
+	- Reads are validated against a per-frame sequence number (seqlock) and retried if the writer overwrote the frame mid-read
+	- Data can be copied out in blocks, or borrowed in place by readers that finish quickly (reads are validated either way)
     - Each observer needs it's own pre-allocated buffer to copy the data into (observer creates this itself so memory allocation not triggered on realtime thread)
 
 */
@@ -55,6 +60,130 @@ using ListenerCallback = std::function<void()>;
 using ListenerRemovalCallback = std::function<void()>;
 
 
+/**
+*   A fixed-capacity table of listener callbacks which can be notified from the real time audio thread while listeners are being added
+*   or removed on other threads. Notification is wait-free and never allocates. Any allocation needed to store a callback happens in
+*   add(), on the thread adding the listener.
+*
+*   Each slot has a busy flag which the notifying thread raises while it checks and calls the slot's callback. Removal first deactivates
+*   the slot and then waits for the flag to drop before destroying the callback, so a callback is never destroyed while it is running.
+*   Hence removal must not be performed from within a callback or on the audio thread.
+*/
+class ListenerCallbackRegistry
+{
+public:
+
+    /** Maximum number of listeners that can be registered at any one time. */
+    static constexpr int maxNumListeners = 8;
+
+    ListenerCallbackRegistry() = default;
+
+    ~ListenerCallbackRegistry()
+    {
+        masterReference.clear();
+    }
+
+    /** Adds a callback to the first free slot. Returns a ListenerRemovalCallback which de-registers it (and does nothing if this
+     *  registry no longer exists), or an empty function if the table is full. */
+    ListenerRemovalCallback add (ListenerCallback&& listenerCallback)
+    {
+        for (auto i = 0; i < maxNumListeners; ++i)
+        {
+            auto& slot = slots[i];
+            auto expected = SlotState::free;
+            if (slot.state.compare_exchange_strong (expected, SlotState::claimed))
+            {
+                slot.callback = std::move (listenerCallback);
+                const auto generation = slot.generation.load (std::memory_order_relaxed);
+                numListeners.fetch_add (1);
+                slot.state.store (SlotState::active);
+
+                WeakReference<ListenerCallbackRegistry> weakThis = this;
+                return [this, weakThis, i, generation] ()
+                {
+                    // Check the WeakReference because the callback may live longer than this registry
+                    if (weakThis)
+                        remove (i, generation);
+                };
+            }
+        }
+        jassertfalse; // Listener table is full
+        return {};
+    }
+
+    /** Calls every registered callback. This is wait-free, so it is safe to call on the audio thread. */
+    void notify()
+    {
+        if (numListeners.load (std::memory_order_relaxed) == 0)
+            return;
+
+        for (auto& slot : slots)
+        {
+            slot.busy.store (true);
+            if (slot.state.load() == SlotState::active && slot.callback)
+                slot.callback();
+            slot.busy.store (false, std::memory_order_release);
+        }
+    }
+
+    /** Indicates whether any callbacks are registered. */
+    [[nodiscard]] bool hasListeners() const noexcept
+    {
+        return numListeners.load (std::memory_order_relaxed) > 0;
+    }
+
+private:
+
+    enum class SlotState
+    {
+        free,
+        claimed,
+        active
+    };
+
+    struct Slot
+    {
+        std::atomic<SlotState> state { SlotState::free };
+        std::atomic<bool> busy { false };
+        std::atomic<uint32> generation { 0 };   // Incremented on removal so stale removal callbacks can't remove a later listener
+        ListenerCallback callback {};
+    };
+
+    void remove (const int index, const uint32 generation)
+    {
+        auto& slot = slots[index];
+        if (slot.generation.load (std::memory_order_acquire) != generation)
+            return; // Already removed
+
+        auto expected = SlotState::active;
+        if (! slot.state.compare_exchange_strong (expected, SlotState::claimed))
+            return;
+
+        // Wait for any notification in progress on this slot to finish before destroying the callback
+        while (slot.busy.load())
+            Thread::yield();
+
+        slot.callback = nullptr;
+        slot.generation.fetch_add (1, std::memory_order_release);
+        numListeners.fetch_sub (1);
+        slot.state.store (SlotState::free, std::memory_order_release);
+    }
+
+    Slot slots[maxNumListeners];
+    std::atomic<int> numListeners { 0 };
+
+    WeakReference<ListenerCallbackRegistry>::Master masterReference;
+    friend class WeakReference<ListenerCallbackRegistry>;
+
+public:
+    // Declare non-copyable, non-movable
+    ListenerCallbackRegistry (const ListenerCallbackRegistry&) = delete;
+    ListenerCallbackRegistry& operator= (const ListenerCallbackRegistry&) = delete;
+    ListenerCallbackRegistry (ListenerCallbackRegistry&& other) = delete;
+    ListenerCallbackRegistry& operator=(ListenerCallbackRegistry&& other) = delete;
+};
+
+
 /**
 *   This class is designed to be used by a real time audio process which needs to safely and asynchronously transfer non-POD data to one or many 
 *	observers. A series of objects of the template type are written to a lock-free queue for later reading by the observers. This pattern
@@ -65,11 +194,14 @@ using ListenerRemovalCallback = std::function<void()>;
 *   suits them. There is no guarantee that all written frames will be read by an observer, they simply sample whatever is
 *   there at the time. Optionally, an observer can register as a listener so that it is notified whenever data has been written.
 *
-*   Data is written one frame at a time. It is also copied out one frame at a time by observers. The use of a copy method
-*   for reading minimises the risk of data tearing. Tearing can only occur if the write method overwrites the read
-*   position during the non-atomic copy operation. Hence the risk is a function of the queue length.
+*   Each frame slot in the queue carries a sequence number (a seqlock). The writer makes the sequence odd before writing a slot
+*   and even again once the write is complete. Readers note the sequence before reading, re-check it afterwards and retry if the
+*   writer has touched the slot in the meantime, so a torn frame is never handed back as valid. The writer never blocks on readers.
+*
+*   Readers either copy a frame out with copyFrame(), or borrow the latest frame in place with readLatestFrame() if they can finish
+*   with it quickly (e.g. building a path from it) and so avoid the copy altogether.
 *  
-*   The FrameType used for the data frame must be of fixed size at compile time. For example:
+*   The FrameType used for the data frame must be of fixed size at compile time and trivially copyable. For example:
 *  
 *   struct SimpleDataFrame
 *	{
@@ -82,16 +214,17 @@ class AudioProbe
 public:
 
     /* Constructor. Optionally specify the length of the queue. */
-	explicit AudioProbe(const int queueLengthInFrames = 3	/**< Number of frames in queue. Higher values have lower risk of data tearing. */)
-        : numFramesInQueue (queueLengthInFrames),
-        writeIndex (1),
-        readIndex (0),
+	explicit AudioProbe(const int queueLengthInFrames = 3	/**< Number of frames in queue. Higher values make read retries less likely. */)
+        : numFramesInQueue (jmax (2, queueLengthInFrames)),
         frameSize (sizeof (FrameType))
     {
-        // Allocate memory for queue
+        static_assert (std::is_trivially_copyable<FrameType>::value, "AudioProbe frames are copied with memcpy");
+
+        // Allocate memory for queue and sequence numbers (all slots start out stable)
 		writeQueue.allocate (numFramesInQueue, false);
+        sequenceNumbers.allocate (numFramesInQueue, true);
         // Intialise frame at read position
-		writeQueue[readIndex] = FrameType ();
+		writeQueue[readIndex.load()] = FrameType ();
     }
 
     /* 
@@ -99,27 +232,73 @@ public:
      * is undefined. For audio plugins, we shouldn't need to worry about delayed reads from listeners arriving during destruction because the
      * AudioProcessorEditor should always be destroyed before it's parent AudioProcessor.
      */
-    ~AudioProbe()
-	{
-	    masterReference.clear();
-	}
+    ~AudioProbe() = default;
 
-    /** Writes a data frame to the queue and will thus overwrite anything altered using getWritePointer(). */
+    /** Writes a data frame to the queue. Only one thread may write. */
     void writeFrame (const FrameType* source)
     {
-        jassert (writeIndex != readIndex);
-        std::memcpy (&writeQueue[writeIndex], source, frameSize);
-        finishedWrite();
+        // Always write to the slot after the one currently published so readers of the latest frame are undisturbed
+        auto index = readIndex.load (std::memory_order_relaxed) + 1;
+        if (index == numFramesInQueue)
+            index = 0;
+
+        auto& sequence = sequenceNumbers[index];
+        const auto s = sequence.load (std::memory_order_relaxed);
+        sequence.store (s + 1, std::memory_order_relaxed);      // Odd: slot is being written
+        std::atomic_thread_fence (std::memory_order_release);
+        std::memcpy (&writeQueue[index], source, frameSize);
+        sequence.store (s + 2, std::memory_order_release);      // Even: slot is stable again
+
+        finishedWrite (index);
+    }
+
+	/** Copies the latest data frame into the destination.
+	*	The copy is validated against the slot's sequence number and retried if the writer overwrote the slot during the copy.
+	*	Returns false (leaving the destination in an unspecified state) in the unlikely event that no consistent copy could be made
+	*	after several attempts, in which case the observer should simply try again later. Observers should pre-allocate a member
+	*	variable of FrameType to copy into if performance is critical. */
+    bool copyFrame (FrameType* destination) const
+    {
+        return readLatestFrame ([this, destination] (const FrameType& frame)
+        {
+            std::memcpy (destination, &frame, frameSize);
+        });
+    }
+
+	/**
+	 *  Lends the latest data frame to the reader (any callable taking a const FrameType&) without copying it. Once the reader
+	 *  returns, the slot's sequence number is checked and the reader is called again if the frame was overwritten in the meantime.
+	 *  Hence the reader must be quick (so that the writer doesn't lap it), must reset any state it accumulates at the start of each
+	 *  call and must not keep a reference to the frame after it returns.
+	 *
+	 *  Returns true if the last call to the reader saw a consistent frame, or false if no consistent frame could be read after
+	 *  several attempts (in which case anything derived from the frame should be discarded).
+	 */
+    template <typename FrameReader>
+    bool readLatestFrame (FrameReader&& reader) const
+    {
+        for (auto attempt = 0; attempt < maxReadAttempts; ++attempt)
+        {
+            const auto index = readIndex.load (std::memory_order_acquire);
+            const auto& sequence = sequenceNumbers[index];
+            const auto before = sequence.load (std::memory_order_acquire);
+
+            if ((before & 1u) != 0)
+                continue;   // Writer has lapped us and is currently in this slot
+
+            reader (static_cast<const FrameType&> (writeQueue[index]));
+
+            std::atomic_thread_fence (std::memory_order_acquire);
+            if (sequence.load (std::memory_order_relaxed) == before)
+                return true;
+        }
+        return false;
     }
 
-	/** Copies current data frame at read index into the destination.
-	*	Direct access to the current data frame isn't allowed as any non atomic access risks data tearing. By using a lock-free queue
-	*	and copying out in one operation, the risk of data tearing is extremely low (an assertion will throw if this does happen).
-	*	Observers/listeners should pre-allocate a member variable of ElementType to copy into if performance is critical. */
-    void copyFrame (FrameType* destination)
+    /** Returns the number of frames written so far, which observers can compare to see whether there is a new frame to read. */
+    [[nodiscard]] uint32 getNumFramesWritten() const noexcept
     {
-        jassert (writeIndex != readIndex);
-        std::memcpy (destination, &writeQueue[readIndex], frameSize);
+        return numFramesWritten.load (std::memory_order_acquire);
     }
 
 	/**
@@ -129,58 +308,45 @@ public:
 	 *  make sure that it's owner still exists before it attempts to do anything (e.g. check a WeakReference to itself).
 	 *
      *  Returns a ListenerRemovalCallback which allows the listener to de-register the callback that was just added. It's probably
-     *  worth initialising any ListenerRemovalCallback class members used to hold this return value to an empty function.
+     *  worth initialising any ListenerRemovalCallback class members used to hold this return value to an empty function. Listeners can
+     *  be added and removed while audio is running (see ListenerCallbackRegistry), but not from the audio thread.
      */
     ListenerRemovalCallback addListenerCallback (ListenerCallback &&listenerCallback)
     {
-        WeakReference<AudioProbe<FrameType>> weakThis = this;
-        auto thisListener = listenerCallbacks.emplace (listenerCallbacks.begin(), listenerCallback);
-        return [this, weakThis, thisListener] ()
-        {
-            // Check the WeakReference because the callback may live longer than this AudioProbe
-            if (weakThis)
-                listenerCallbacks.erase (thisListener);
-        };
+        return listeners.add (std::move (listenerCallback));
     }
 
 	/**
     *   Indicates whether the probe has any listeners. In the case where all observers are listeners, this can be used by the sender to
-																																	  
     *   choose whether to suspend non-essential processing (e.g. don't bother computing an FFT for a GUI if there are no GUIs attached).
     *   This is of no use if the observers call copyFrame() of their own volition (e.g. during a timerCallback).
     */
     [[nodiscard]] inline bool hasListeners() const
 	{
-		return !listenerCallbacks.empty();
+		return listeners.hasListeners();
 	}
 
 private:
 
 	/** This is called when the writer has completed writing a data frame. */
-    void finishedWrite()
+    void finishedWrite (const int index)
     {
-        jassert (writeIndex != readIndex);
-        readIndex = writeIndex;
-        writeIndex++;
-        if (writeIndex == numFramesInQueue)
-            writeIndex = 0;
+        readIndex.store (index, std::memory_order_release);
+        numFramesWritten.store (numFramesWritten.load (std::memory_order_relaxed) + 1, std::memory_order_release);
         
         // Perform registered callbacks
-        for (auto &&callback : listenerCallbacks)
-        {
-            if (callback)
-                callback();
-        }
+        listeners.notify();
     }
 
-    const int numFramesInQueue; // In units of frame size
-    int writeIndex, readIndex;  // In units of frame size
-    int frameSize;              // In bytes
-    std::list<ListenerCallback> listenerCallbacks{};
-	HeapBlock <FrameType> writeQueue;
+    static constexpr int maxReadAttempts = 8;
 
-    typename WeakReference<AudioProbe<FrameType>>::Master masterReference;
-    friend class WeakReference<AudioProbe<FrameType>>;
+    const int numFramesInQueue;                 // In units of frame size
+    std::atomic<int> readIndex { 0 };           // Index of the most recently published frame
+    std::atomic<uint32> numFramesWritten { 0 };
+    int frameSize;                              // In bytes
+    ListenerCallbackRegistry listeners;
+	HeapBlock <FrameType> writeQueue;
+    HeapBlock<std::atomic<uint32>> sequenceNumbers; // One per frame slot, odd while the slot is being written
 
 public:
     // Declare non-copyable, non-movable
@@ -190,6 +356,219 @@ public:
     AudioProbe& operator=(AudioProbe&& other) = delete;
 };
 
+/**
+*   This class is designed to be used by a real time audio process which needs to stream every data frame it produces to one or more
+*   observers on other threads (e.g. a recorder, a measurement engine or a file writer). Unlike AudioProbe, which lets observers
+*   sample whatever frame happens to be the latest, frames are never overwritten before every registered consumer has read them.
+*
+*   Frames are written by a single writer into a fixed-size, lock-free ring. Each consumer registers for its own read cursor and drains
+*   frames at its own pace, either by copying them out in batches with readFrames() or by visiting them in place with drainFrames().
+*   The writer never blocks or allocates: if the slowest consumer has let the ring fill up, then the new frame is discarded and counted
+*   as dropped so that consumers can report the overflow (see getNumFramesDropped()). With no consumers registered, frames are simply
+*   written and nobody reads them.
+*
+*   Consumers are registered and removed on a non-realtime thread. A consumer must only be drained by one thread at a time, but different
+*   consumers can be drained on different threads. The FrameType has the same requirements as for AudioProbe.
+*/
+template <class FrameType>
+class AudioStreamingProbe
+{
+public:
+
+    /** Constructor. The capacity is rounded up to a power of two. */
+    explicit AudioStreamingProbe (const int capacityInFrames = 32,  /**< Number of frames the slowest consumer may lag behind by before frames are dropped. */
+                                  const int maximumNumConsumers = 4 /**< Size of the fixed consumer table. */)
+        : capacity (nextPowerOfTwo (jmax (2, capacityInFrames))),
+          maxConsumers (jmax (1, maximumNumConsumers)),
+          frameSize (sizeof (FrameType))
+    {
+        static_assert (std::is_trivially_copyable<FrameType>::value, "AudioStreamingProbe frames are copied with memcpy");
+
+        frames.allocate (capacity, true);
+        consumers.allocate (maxConsumers, true);
+    }
+
+    ~AudioStreamingProbe() = default;
+
+    /** Writes a data frame to the ring. Only one thread may write. Returns false if the frame was dropped because a consumer has
+     *  fallen a whole ring behind. */
+    bool writeFrame (const FrameType* source)
+    {
+        const auto position = writePosition.load (std::memory_order_relaxed);
+
+        if (position - getOldestReadPosition (position) >= static_cast<uint64> (capacity))
+        {
+            numFramesDropped.store (numFramesDropped.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+            return false;
+        }
+
+        std::memcpy (&frames[static_cast<int> (position & static_cast<uint64> (capacity - 1))], source, frameSize);
+        writePosition.store (position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Registers a consumer which will receive every frame written from now on. Returns the consumer's index for use with the drain
+     *  methods, or -1 if the consumer table is full. Call this on a non-realtime thread. */
+    int addConsumer()
+    {
+        for (auto i = 0; i < maxConsumers; ++i)
+        {
+            auto& consumer = consumers[i];
+            auto expected = static_cast<int> (ConsumerState::free);
+            if (consumer.state.compare_exchange_strong (expected, static_cast<int> (ConsumerState::claimed)))
+            {
+                consumer.readPosition.store (writePosition.load (std::memory_order_acquire), std::memory_order_relaxed);
+                consumer.numFramesDroppedAtStart = numFramesDropped.load (std::memory_order_acquire);
+                consumer.state.store (static_cast<int> (ConsumerState::active), std::memory_order_release);
+                numConsumers.fetch_add (1);
+
+                // The writer ignored this consumer until it became active, so skip anything it may have lapped in the meantime
+                const auto position = writePosition.load (std::memory_order_acquire);
+                if (position - consumer.readPosition.load (std::memory_order_relaxed) > static_cast<uint64> (capacity))
+                    consumer.readPosition.store (position, std::memory_order_release);
+
+                return i;
+            }
+        }
+        jassertfalse; // Consumer table is full, construct with a larger maximumNumConsumers
+        return -1;
+    }
+
+    /** De-registers a consumer so that it no longer holds the writer back. Call this on a non-realtime thread. */
+    void removeConsumer (const int consumerIndex)
+    {
+        jassert (isPositiveAndBelow (consumerIndex, maxConsumers));
+        auto expected = static_cast<int> (ConsumerState::active);
+        if (consumers[consumerIndex].state.compare_exchange_strong (expected, static_cast<int> (ConsumerState::free)))
+            numConsumers.fetch_sub (1);
+    }
+
+    /** Indicates whether any consumers are registered, so that the writer can skip producing frames nobody will read. */
+    [[nodiscard]] bool hasConsumers() const noexcept
+    {
+        return numConsumers.load (std::memory_order_relaxed) > 0;
+    }
+
+    /** Returns the number of frames waiting to be drained by a consumer. */
+    [[nodiscard]] int getNumFramesReady (const int consumerIndex) const
+    {
+        const auto& consumer = getActiveConsumer (consumerIndex);
+        return static_cast<int> (writePosition.load (std::memory_order_acquire) - consumer.readPosition.load (std::memory_order_relaxed));
+    }
+
+    /** Copies up to maxFrames of the oldest unread frames for a consumer into destination and returns the number of frames copied. */
+    int readFrames (const int consumerIndex, FrameType* destination, const int maxFrames)
+    {
+        return drainFrames (consumerIndex, maxFrames, [this, &destination] (const FrameType* source, const int numFrames)
+        {
+            std::memcpy (destination, source, static_cast<size_t> (numFrames) * frameSize);
+            destination += numFrames;
+        });
+    }
+
+    /**
+     *  Visits up to maxFrames of the oldest unread frames for a consumer in place and then releases them back to the writer. The visitor
+     *  is a callable taking (const FrameType* frames, int numFrames) and is called once, or twice if the frames wrap around the end of
+     *  the ring. Returns the number of frames drained.
+     */
+    template <typename FrameVisitor>
+    int drainFrames (const int consumerIndex, const int maxFrames, FrameVisitor&& visitor)
+    {
+        auto& consumer = getActiveConsumer (consumerIndex);
+        const auto position = consumer.readPosition.load (std::memory_order_relaxed);
+        const auto numAvailable = writePosition.load (std::memory_order_acquire) - position;
+        const auto numFrames = static_cast<int> (jmin (numAvailable, static_cast<uint64> (jmax (0, maxFrames))));
+
+        if (numFrames > 0)
+        {
+            const auto start = static_cast<int> (position & static_cast<uint64> (capacity - 1));
+            const auto numBeforeWrap = jmin (numFrames, capacity - start);
+            visitor (static_cast<const FrameType*> (&frames[start]), numBeforeWrap);
+            if (numFrames > numBeforeWrap)
+                visitor (static_cast<const FrameType*> (&frames[0]), numFrames - numBeforeWrap);
+
+            consumer.readPosition.store (position + static_cast<uint64> (numFrames), std::memory_order_release);
+        }
+        return numFrames;
+    }
+
+    /** Returns the total number of frames accepted by the ring. */
+    [[nodiscard]] uint64 getNumFramesWritten() const noexcept
+    {
+        return writePosition.load (std::memory_order_acquire);
+    }
+
+    /** Returns the total number of frames dropped because the ring was full. */
+    [[nodiscard]] uint64 getNumFramesDropped() const noexcept
+    {
+        return numFramesDropped.load (std::memory_order_acquire);
+    }
+
+    /** Returns the number of frames dropped since a consumer was registered, i.e. the number of frames it has missed. */
+    [[nodiscard]] uint64 getNumFramesDropped (const int consumerIndex) const
+    {
+        return getNumFramesDropped() - getActiveConsumer (consumerIndex).numFramesDroppedAtStart;
+    }
+
+    /** Gets the capacity of the ring in frames. */
+    [[nodiscard]] int getCapacity() const noexcept
+    {
+        return capacity;
+    }
+
+private:
+
+    enum class ConsumerState : int
+    {
+        free = 0,
+        claimed,
+        active
+    };
+
+    struct ConsumerSlot
+    {
+        std::atomic<int> state;             // ConsumerState
+        std::atomic<uint64> readPosition;   // Absolute frame position (not wrapped)
+        uint64 numFramesDroppedAtStart;
+    };
+
+    /** Returns the read position of the slowest active consumer (or the write position if there are none). */
+    uint64 getOldestReadPosition (const uint64 position) const
+    {
+        auto oldest = position;
+        for (auto i = 0; i < maxConsumers; ++i)
+        {
+            const auto& consumer = consumers[i];
+            if (consumer.state.load (std::memory_order_acquire) == static_cast<int> (ConsumerState::active))
+                oldest = jmin (oldest, consumer.readPosition.load (std::memory_order_acquire));
+        }
+        return oldest;
+    }
+
+    ConsumerSlot& getActiveConsumer (const int consumerIndex) const
+    {
+        jassert (isPositiveAndBelow (consumerIndex, maxConsumers));
+        jassert (consumers[consumerIndex].state.load() == static_cast<int> (ConsumerState::active));
+        return consumers[consumerIndex];
+    }
+
+    const int capacity;         // In units of frame size (power of two)
+    const int maxConsumers;
+    const size_t frameSize;     // In bytes
+    std::atomic<uint64> writePosition { 0 };
+    std::atomic<uint64> numFramesDropped { 0 };
+    std::atomic<int> numConsumers { 0 };
+    HeapBlock<FrameType> frames;
+    HeapBlock<ConsumerSlot> consumers;
+
+public:
+    // Declare non-copyable, non-movable
+    AudioStreamingProbe (const AudioStreamingProbe&) = delete;
+    AudioStreamingProbe& operator= (const AudioStreamingProbe&) = delete;
+    AudioStreamingProbe (AudioStreamingProbe&& other) = delete;
+    AudioStreamingProbe& operator=(AudioStreamingProbe&& other) = delete;
+};
+
 /**
 *	This abstract class is used to provide the capability to stream data to elsewhere in a real time audio process at
 *   a fixed block size which is independent of the block size of the source stream. Derivations need to implement the
@@ -256,7 +635,11 @@ public:
             currentIndex[ch] = 0;
     }
 
-	/** Appends data to the buffer. */
+	/** Appends data for one channel. Whole blocks found in the source data are handed straight to performProcessing() without being
+	 *  copied into the internal buffer (as long as the current block size is the maximum block size), so there is no copy at all in
+	 *  the common case where the device block size is a multiple of the fixed block size. Anything left over is buffered until the
+	 *  next call completes the block.
+	 */
 	void appendData (const int channel,		/**< Channel to which data is going to be appended */
 		             const int numSamples,	/**< Number of samples to be appended */
 		             const float* data		/**< Pointer to source data */
@@ -267,49 +650,70 @@ public:
         jassert (channel >= 0 && channel < numChannels);
         jassert (numSamples > 0);   // If this assert fires then you probably haven't called prepare()
 
-        if (data != nullptr)
+        if (data == nullptr)
+            return;
+
+        auto& index = currentIndex[channel];
+        auto samplesRemaining = numSamples;
+        auto dataOffset = 0;
+
+        if (index > 0)
         {
-            if (currentIndex[channel] + numSamples < currentBlockSize)
+            // Top up the partially filled channel buffer and process it if it is now full
+            const auto num = jmin (samplesRemaining, currentBlockSize - index);
+            buffer.copyFrom (channel, index, data, num);
+            index += num;
+            samplesRemaining -= num;
+            dataOffset += num;
+
+            if (index < currentBlockSize)
+                return;
+
+            performProcessing (channel, buffer.getReadPointer (channel));
+            index = 0;
+        }
+
+        // Loop full blocks (processing them directly from the source where possible)
+        while (samplesRemaining >= currentBlockSize)
+        {
+            if (currentBlockSize == maxBlockSize)
             {
-                // Data can't fill the channel buffer, so write what we have
-                buffer.copyFrom (channel, currentIndex[channel], data, numSamples);
-                currentIndex[channel] += numSamples;
+                performProcessing (channel, data + dataOffset);
             }
             else
             {
-                // We have more data than can fit in the channel buffer
-                auto samplesRemaining = numSamples;
-                auto dataOffset = 0;
-
-                // Write remainder of channel buffer and process
-                const auto rem = currentBlockSize - currentIndex[channel];
-                buffer.copyFrom (channel, currentIndex[channel], data, rem);
-                performProcessing (channel);
-                currentIndex[channel] = 0;
-                samplesRemaining -= rem;
-                dataOffset += rem;
-
-                // Loop full blocks (processing as we go)
-                while (samplesRemaining >= currentBlockSize)
-                {
-                    buffer.copyFrom (channel, currentIndex[channel], data + dataOffset, currentBlockSize);
-                    performProcessing (channel);
-                    samplesRemaining -= currentBlockSize;
-                    dataOffset += currentBlockSize;
-                }
-
-                if (samplesRemaining > 0)
-                {
-                    // Write remainder of input
-                    buffer.copyFrom (channel, currentIndex[channel], data + dataOffset, samplesRemaining);
-                    currentIndex[channel] = samplesRemaining;
-                }
+                // Stage smaller blocks so derivations can always read getMaximumBlockSize() samples
+                buffer.copyFrom (channel, 0, data + dataOffset, currentBlockSize);
+                performProcessing (channel, buffer.getReadPointer (channel));
             }
+            samplesRemaining -= currentBlockSize;
+            dataOffset += currentBlockSize;
         }
+
+        if (samplesRemaining > 0)
+        {
+            // Write remainder of input
+            buffer.copyFrom (channel, 0, data + dataOffset, samplesRemaining);
+            index = samplesRemaining;
+        }
+    }
+
+    /** Appends data for all channels of a block in one call (any channels beyond those prepared are ignored). */
+    template <typename SampleType>
+    void appendData (const dsp::AudioBlock<SampleType>& block)
+    {
+        static_assert (std::is_same<typename std::remove_const<SampleType>::type, float>::value, "FixedBlockProcessor only operates on float data");
+
+        const auto numSamples = static_cast<int> (block.getNumSamples());
+        const auto numBlockChannels = jmin (numChannels, static_cast<int> (block.getNumChannels()));
+        for (auto ch = 0; ch < numBlockChannels; ++ch)
+            appendData (ch, numSamples, block.getChannelPointer (static_cast<size_t> (ch)));
     }
 
-	/** Abstract function which is called whenever the fixed size buffer has been filled. */
-	virtual void performProcessing (const int channel	/**< Channel for which processing is to be performed */ ) = 0;
+	/** Abstract function which is called whenever a fixed size block is ready. The data is only valid for the duration of the call
+	 *  and may point either into the internal buffer or directly into the source data passed to appendData(). */
+	virtual void performProcessing (const int channel,	/**< Channel for which processing is to be performed */
+                                    const float* data	/**< The block to be processed (getCurrentBlockSize() samples) */ ) = 0;
    
 protected:
 
@@ -338,4 +742,88 @@ public:
     FixedBlockProcessor& operator= (const FixedBlockProcessor&) = delete;
     FixedBlockProcessor (FixedBlockProcessor&& other) = delete;
     FixedBlockProcessor& operator=(FixedBlockProcessor&& other) = delete;
+};
+
+
+/**
+*   Passes an immutable snapshot of parameters from a writer thread (typically the message thread) to the real time audio thread.
+*
+*   The writer publishes a complete copy of the parameters whenever any of them change, and the audio thread picks up the latest
+*   snapshot at the start of each block by swapping a pointer. The audio thread never allocates, frees or waits. Snapshots it has
+*   finished with are pushed onto a lock-free list and freed by the writer the next time it publishes (or on destruction).
+*
+*   There must be a single writer thread and a single reader thread. The reference returned by acquire() remains valid until the
+*   next call to acquire().
+*/
+template <class ParameterType>
+class ParameterSnapshot
+{
+public:
+
+    ParameterSnapshot()
+        : current (new Node())
+    { }
+
+    explicit ParameterSnapshot (const ParameterType& initialParameters)
+        : current (new Node { initialParameters, nullptr })
+    { }
+
+    ~ParameterSnapshot()
+    {
+        delete pending.exchange (nullptr);
+        freeRetired();
+        delete current;
+    }
+
+    /** Publishes a new set of parameters (replacing any that haven't been picked up yet). Call this on the writer thread only. */
+    void publish (const ParameterType& newParameters)
+    {
+        freeRetired();
+        delete pending.exchange (new Node { newParameters, nullptr });
+    }
+
+    /** Picks up the most recently published parameters, if there are any, and returns the current parameters. This is wait-free and
+     *  never allocates, so it is safe to call on the audio thread (call it once per block and use the reference for the whole block). */
+    const ParameterType& acquire() noexcept
+    {
+        if (auto* latest = pending.exchange (nullptr, std::memory_order_acquire))
+        {
+            // Hand the previous snapshot back to the writer to free
+            auto* previous = current;
+            previous->next = retired.load (std::memory_order_relaxed);
+            while (!retired.compare_exchange_weak (previous->next, previous, std::memory_order_release, std::memory_order_relaxed)) {}
+            current = latest;
+        }
+        return current->parameters;
+    }
+
+private:
+
+    struct Node
+    {
+        ParameterType parameters{};
+        Node* next = nullptr;
+    };
+
+    void freeRetired()
+    {
+        auto* node = retired.exchange (nullptr, std::memory_order_acquire);
+        while (node != nullptr)
+        {
+            auto* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    Node* current;                              // Only accessed by the reader
+    std::atomic<Node*> pending { nullptr };     // Published but not yet picked up by the reader
+    std::atomic<Node*> retired { nullptr };     // Stack of snapshots the reader has finished with
+
+public:
+    // Declare non-copyable, non-movable
+    ParameterSnapshot (const ParameterSnapshot&) = delete;
+    ParameterSnapshot& operator= (const ParameterSnapshot&) = delete;
+    ParameterSnapshot (ParameterSnapshot&& other) = delete;
+    ParameterSnapshot& operator=(ParameterSnapshot&& other) = delete;
 };
\ No newline at end of file
@@ -16,6 +16,14 @@
 	This class inherits from FixedBlockProcessor so that it can run on the audio processing thread and allow an audio scope
 	to be delivered data at a fixed block size, regardless of the block sized used by the audio device or host. An AudioProbe object
 	is then used to make the processed data available for use on other threads.
+
+	Frames can optionally be aligned to a trigger (rising or falling edge with hysteresis and holdoff) found on one channel, so that
+	periodic signals are displayed as a stable waveform. The last two frames of each channel are kept so that a trigger found anywhere in
+	the latest frame can be published with the requested proportion of pre-trigger samples, which delays the display by one frame. If no
+	trigger is found for a while, free running frames are published instead (i.e. auto triggering) so the display never freezes.
+
+	Consecutive (untriggered) frames are also streamed losslessly to any registered stream consumers, which is used to capture a
+	longer history than a single frame.
 */
 class AudioScopeProcessor final : public FixedBlockProcessor
 {
@@ -26,16 +34,43 @@ public:
     struct OscilloscopeFrame final
     {
 	    alignas(16) float f[frame_size];
+        float triggerPosition;  // Position of the trigger within f in samples (including the sub-sample offset), or -1 if not triggered
+    };
+
+    struct StreamFrame final
+    {
+        alignas(16) float f[frame_size];
+    };
+
+    /** Trigger modes (values are used as ComboBox IDs). */
+    enum class TriggerMode
+    {
+        FreeRunning = 1,
+        RisingEdge,
+        FallingEdge
     };
 
     explicit AudioScopeProcessor();
     ~AudioScopeProcessor() override = default;
 
     void prepare (const dsp::ProcessSpec& spec) override;
-    void performProcessing (const int channel) override;
+    void performProcessing (const int channel, const float* data) override;
 
-    /** Copy frame of audio data */
-    void copyFrame (float* dest, const int channel) const;
+    using FixedBlockProcessor::appendData;
+
+    /** Appends data for all channels in one call. The trigger channel is appended first so that the other channels can be aligned to
+     *  the same trigger points. */
+    template <typename SampleType>
+    void appendData (const dsp::AudioBlock<SampleType>& block);
+
+    /** Copy frame of audio data. Returns false if no consistent frame could be copied (try again later). Optionally returns the
+     *  position of the trigger within the frame (or -1 if the frame wasn't triggered). */
+    bool copyFrame (float* dest, const int channel, float* triggerPosition = nullptr) const;
+
+    /** Lends the latest frame of audio data to the reader (a callable taking a const float*) without copying it.
+     *  See AudioProbe::readLatestFrame() for the constraints on the reader. */
+    template <typename FrameReader>
+    bool readFrame (const int channel, FrameReader&& reader) const;
 
     /** Allows a listener to add a lambda function as a callback to the AudioProbe assigned to the last channel.
      *  Listener callbacks are cleared each time prepare() is called on this class, so they must be added after this.
@@ -45,9 +80,82 @@ public:
      */
     ListenerRemovalCallback addListenerCallback (ListenerCallback&& listenerCallback) const;
 
+    /** Registers a consumer which will be streamed every frame of every channel from now on. Returns the consumer's index, or -1 if
+     *  no more consumers can be added. Stream consumers are cleared each time prepare() is called on this class. */
+    int addStreamConsumer();
+
+    /** De-registers a stream consumer. */
+    void removeStreamConsumer (const int consumer);
+
+    /** Visits the frames streamed to a consumer for one channel since it last drained them. The visitor is a callable taking
+     *  (const float* samples, int numSamples). Returns the number of samples drained. */
+    template <typename SampleVisitor>
+    int drainStream (const int consumer, const int channel, SampleVisitor&& visitor);
+
+    /** Gets the sample rate passed to prepare(). */
+    [[nodiscard]] double getSampleRate() const noexcept;
+
+    void setTriggerMode (const TriggerMode mode);
+    [[nodiscard]] TriggerMode getTriggerMode() const;
+
+    /** Sets the channel which is scanned for trigger points (defaults to the first channel). */
+    void setTriggerChannel (const int channel);
+    [[nodiscard]] int getTriggerChannel() const;
+
+    /** Sets the trigger level as a linear amplitude. */
+    void setTriggerLevel (const float level);
+    [[nodiscard]] float getTriggerLevel() const;
+
+    /** Sets the hysteresis as a linear amplitude. The signal must move this far past the level in the opposite direction to the
+     *  trigger edge before the trigger is re-armed, which stops noisy signals from re-triggering around the level. */
+    void setTriggerHysteresis (const float hysteresis);
+    [[nodiscard]] float getTriggerHysteresis() const;
+
+    /** Sets the minimum time between trigger points. */
+    void setTriggerHoldoffMs (const double holdoffMs);
+    [[nodiscard]] double getTriggerHoldoffMs() const;
+
+    /** Sets the proportion of the frame which comes before the trigger point (0 to 1). */
+    void setPreTriggerProportion (const float proportion);
+    [[nodiscard]] float getPreTriggerProportion() const;
 
 private:
+
+    /** A trigger decision made for a frame on the trigger channel, which is then applied to every channel. */
+    struct TriggerDecision
+    {
+        int64 frameNumber = -1;
+        int start = -1;                 // Offset of the published frame within the history (or -1 to publish nothing)
+        float triggerPosition = -1.0f;  // Trigger position within the published frame (or -1 if not triggered)
+    };
+
+    TriggerDecision makeTriggerDecision (const float* history, const int64 frameNumber);
+
+    static constexpr int maxFramesPerDecision = 8;  // Size of decision ring (must be a power of two)
+    static constexpr int scanChunkSize = 64;        // Chunks are skipped with a vectorised min/max test where they can't hold a transition
+    static constexpr int autoTriggerFrames = 4;     // Number of frames without a trigger before free running frames are published
+
+    static constexpr int streamCapacityInFrames = 64;
+
     OwnedArray <AudioProbe <OscilloscopeFrame>> audioProbes{};
+    OwnedArray <AudioStreamingProbe <StreamFrame>> streamProbes{};
+
+    AudioSampleBuffer history;          // Last two frames for each channel
+    HeapBlock<int64> frameCounts;
+    TriggerDecision decisions[maxFramesPerDecision];
+    OscilloscopeFrame outputFrame {};
+    double sampleRate = 44100.0;
+    int triggerChannelInUse = 0;
+    bool triggerArmed = false;
+    int64 nextTriggerAllowed = 0;
+    int64 lastTriggerFrame = 0;
+
+    Atomic<int> triggerMode = static_cast<int> (TriggerMode::FreeRunning);
+    Atomic<int> triggerChannel = 0;
+    Atomic<float> triggerLevel = 0.0f;
+    Atomic<float> triggerHysteresis = 0.01f;
+    Atomic<double> triggerHoldoffMs = 0.0;
+    Atomic<float> preTriggerProportion = 0.1f;
 
 public:
     // Declare non-copyable, non-movable
@@ -70,21 +178,166 @@ inline void AudioScopeProcessor::prepare (const dsp::ProcessSpec& spec)
 {
     FixedBlockProcessor::prepare (spec);
 
+    sampleRate = spec.sampleRate;
+    history.setSize (static_cast<int> (spec.numChannels), frame_size * 2, false, true, false);
+    frameCounts.allocate (spec.numChannels, true);
+    for (auto& d : decisions)
+        d = TriggerDecision();
+    triggerArmed = false;
+    nextTriggerAllowed = 0;
+    lastTriggerFrame = 0;
+
     audioProbes.clear();
+    streamProbes.clear();
 
     // Add probes for each channel to transfer audio data to the GUI
     for (auto ch = 0; ch < static_cast<int>(spec.numChannels); ++ch)
+    {
         audioProbes.add (new AudioProbe<OscilloscopeFrame>());
+        streamProbes.add (new AudioStreamingProbe<StreamFrame> (streamCapacityInFrames));
+    }
+}
+
+inline void AudioScopeProcessor::performProcessing (const int channel, const float* data)
+{
+    // Keep the last two frames so that a trigger can be published with pre-trigger samples
+    if (streamProbes[channel]->hasConsumers())
+        streamProbes[channel]->writeFrame (reinterpret_cast<const StreamFrame*> (data));
+
+    auto* h = history.getWritePointer (channel);
+    FloatVectorOperations::copy (h, h + frame_size, frame_size);
+    FloatVectorOperations::copy (h + frame_size, data, frame_size);
+    const auto frameNumber = ++frameCounts[channel];
+
+    if (channel == triggerChannelInUse)
+        decisions[frameNumber & (maxFramesPerDecision - 1)] = makeTriggerDecision (h, frameNumber);
+
+    const auto& decision = decisions[frameNumber & (maxFramesPerDecision - 1)];
+    if (decision.frameNumber != frameNumber)
+    {
+        // Channels are out of step with the trigger channel (e.g. it has just been changed), so publish this frame as it is
+        FloatVectorOperations::copy (outputFrame.f, data, frame_size);
+        outputFrame.triggerPosition = -1.0f;
+    }
+    else if (decision.start >= 0)
+    {
+        FloatVectorOperations::copy (outputFrame.f, h + decision.start, frame_size);
+        outputFrame.triggerPosition = decision.triggerPosition;
+    }
+    else
+    {
+        return; // Waiting for a trigger, so keep displaying the last triggered frame
+    }
+
+    audioProbes[channel]->writeFrame (&outputFrame);
+}
+
+template <typename SampleType>
+void AudioScopeProcessor::appendData (const dsp::AudioBlock<SampleType>& block)
+{
+    const auto numSamples = static_cast<int> (block.getNumSamples());
+    const auto numBlockChannels = jmin (getNumChannels(), static_cast<int> (block.getNumChannels()));
+    if (numBlockChannels <= 0)
+        return;
+
+    triggerChannelInUse = jlimit (0, numBlockChannels - 1, triggerChannel.get());
+
+    FixedBlockProcessor::appendData (triggerChannelInUse, numSamples, block.getChannelPointer (static_cast<size_t> (triggerChannelInUse)));
+    for (auto ch = 0; ch < numBlockChannels; ++ch)
+    {
+        if (ch != triggerChannelInUse)
+            FixedBlockProcessor::appendData (ch, numSamples, block.getChannelPointer (static_cast<size_t> (ch)));
+    }
+}
+
+inline AudioScopeProcessor::TriggerDecision AudioScopeProcessor::makeTriggerDecision (const float* h, const int64 frameNumber)
+{
+    TriggerDecision decision;
+    decision.frameNumber = frameNumber;
+
+    const auto mode = static_cast<TriggerMode> (triggerMode.get());
+    if (mode == TriggerMode::FreeRunning || frameNumber < 2)
+    {
+        triggerArmed = false;
+        decision.start = frame_size;
+        return decision;
+    }
+
+    // Work in the direction of the edge so that both edges can be treated as rising
+    const auto sign = mode == TriggerMode::RisingEdge ? 1.0f : -1.0f;
+    const auto level = sign * triggerLevel.get();
+    const auto armLevel = level - std::abs (triggerHysteresis.get());
+    const auto holdoffSamples = jmax (static_cast<int64> (1), static_cast<int64> (triggerHoldoffMs.get() * 0.001 * sampleRate));
+    const auto pre = jlimit (1, frame_size - 1, roundToInt (preTriggerProportion.get() * static_cast<float> (frame_size)));
+
+    // Scanning [pre, frame_size + pre) leaves enough history either side of any trigger found, and successive frames scan contiguous ranges
+    const auto historyStart = (frameNumber - 2) * frame_size; // Absolute position of h[0]
+    const auto end = frame_size + pre;
+    auto found = -1;
+    auto i = pre;
+
+    while (i < end)
+    {
+        const auto chunkEnd = jmin (i + scanChunkSize, end);
+        const auto range = FloatVectorOperations::findMinAndMax (h + i, chunkEnd - i);
+        const auto chunkMin = sign > 0.0f ? range.getStart() : -range.getEnd();
+        const auto chunkMax = sign > 0.0f ? range.getEnd() : -range.getStart();
+
+        // Skip chunks which can't change the trigger state
+        if (triggerArmed ? chunkMax < level : chunkMin >= armLevel)
+        {
+            i = chunkEnd;
+            continue;
+        }
+
+        for (; i < chunkEnd; ++i)
+        {
+            const auto x = sign * h[i];
+            if (! triggerArmed)
+            {
+                triggerArmed = x < armLevel;
+            }
+            else if (x >= level)
+            {
+                triggerArmed = false;
+                if (found < 0 && historyStart + i >= nextTriggerAllowed)
+                    found = i;
+            }
+        }
+    }
+
+    if (found >= 0)
+    {
+        // Interpolate between the samples either side of the crossing for a sub-sample trigger position
+        const auto previous = sign * h[found - 1];
+        const auto current = sign * h[found];
+        const auto fraction = current > previous ? jlimit (0.0f, 1.0f, (level - previous) / (current - previous)) : 1.0f;
+        decision.start = found - pre;
+        decision.triggerPosition = static_cast<float> (pre - 1) + fraction;
+        nextTriggerAllowed = historyStart + found + holdoffSamples;
+        lastTriggerFrame = frameNumber;
+    }
+    else if (frameNumber - lastTriggerFrame > autoTriggerFrames)
+    {
+        decision.start = frame_size; // No trigger for a while, so let the display run free
+    }
+    return decision;
 }
 
-inline void AudioScopeProcessor::performProcessing (const int channel)
+inline bool AudioScopeProcessor::copyFrame (float* dest, const int channel, float* triggerPosition) const
 {
-    audioProbes[channel]->writeFrame (reinterpret_cast<const OscilloscopeFrame*> (buffer.getReadPointer (channel)));
+    return audioProbes[channel]->readLatestFrame ([dest, triggerPosition] (const OscilloscopeFrame& frame)
+    {
+        FloatVectorOperations::copy (dest, frame.f, frame_size);
+        if (triggerPosition != nullptr)
+            *triggerPosition = frame.triggerPosition;
+    });
 }
 
-inline void AudioScopeProcessor::copyFrame (float* dest, const int channel) const
+template <typename FrameReader>
+bool AudioScopeProcessor::readFrame (const int channel, FrameReader&& reader) const
 {
-    audioProbes[channel]->copyFrame (reinterpret_cast<OscilloscopeFrame*>(dest));
+    return audioProbes[channel]->readLatestFrame ([&reader] (const OscilloscopeFrame& frame) { reader (frame.f); });
 }
 
 inline ListenerRemovalCallback AudioScopeProcessor::addListenerCallback (ListenerCallback&& listenerCallback) const
@@ -97,3 +350,103 @@ inline ListenerRemovalCallback AudioScopeProcessor::addListenerCallback (Listene
 
     return {};
 }
+
+inline int AudioScopeProcessor::addStreamConsumer()
+{
+    // If this asserts then you're trying to add the consumer before the probes are set up
+    jassert (getNumChannels() > 0 && streamProbes.size() == getNumChannels());
+
+    // Probes are always added to and removed from together, so they hand out the same index
+    auto consumer = -1;
+    for (auto* probe : streamProbes)
+    {
+        const auto index = probe->addConsumer();
+        jassert (consumer < 0 || index == consumer);
+        consumer = index;
+    }
+    return consumer;
+}
+
+inline void AudioScopeProcessor::removeStreamConsumer (const int consumer)
+{
+    if (consumer < 0)
+        return;
+
+    for (auto* probe : streamProbes)
+        probe->removeConsumer (consumer);
+}
+
+template <typename SampleVisitor>
+int AudioScopeProcessor::drainStream (const int consumer, const int channel, SampleVisitor&& visitor)
+{
+    const auto numFrames = streamProbes[channel]->drainFrames (consumer, streamCapacityInFrames, [&visitor] (const StreamFrame* frames, const int num)
+    {
+        visitor (frames[0].f, num * frame_size);
+    });
+    return numFrames * frame_size;
+}
+
+inline double AudioScopeProcessor::getSampleRate() const noexcept
+{
+    return sampleRate;
+}
+
+inline void AudioScopeProcessor::setTriggerMode (const TriggerMode mode)
+{
+    triggerMode.set (static_cast<int> (mode));
+}
+
+inline AudioScopeProcessor::TriggerMode AudioScopeProcessor::getTriggerMode() const
+{
+    return static_cast<TriggerMode> (triggerMode.get());
+}
+
+inline void AudioScopeProcessor::setTriggerChannel (const int channel)
+{
+    triggerChannel.set (jmax (0, channel));
+}
+
+inline int AudioScopeProcessor::getTriggerChannel() const
+{
+    return triggerChannel.get();
+}
+
+inline void AudioScopeProcessor::setTriggerLevel (const float level)
+{
+    triggerLevel.set (level);
+}
+
+inline float AudioScopeProcessor::getTriggerLevel() const
+{
+    return triggerLevel.get();
+}
+
+inline void AudioScopeProcessor::setTriggerHysteresis (const float hysteresis)
+{
+    triggerHysteresis.set (std::abs (hysteresis));
+}
+
+inline float AudioScopeProcessor::getTriggerHysteresis() const
+{
+    return triggerHysteresis.get();
+}
+
+inline void AudioScopeProcessor::setTriggerHoldoffMs (const double holdoffMs)
+{
+    triggerHoldoffMs.set (jmax (0.0, holdoffMs));
+}
+
+inline double AudioScopeProcessor::getTriggerHoldoffMs() const
+{
+    return triggerHoldoffMs.get();
+}
+
+inline void AudioScopeProcessor::setPreTriggerProportion (const float proportion)
+{
+    preTriggerProportion.set (jlimit (0.0f, 1.0f, proportion));
+}
+
+inline float AudioScopeProcessor::getPreTriggerProportion() const
+{
+    return preTriggerProportion.get();
+}
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    AutomationLane.h
+    Created: 17 Oct 2026 2:41:07pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include <algorithm>
+
+/**
+*   Describes how a ProcessorHarness control is moved over time - either by an LFO centred on the control's manual value, or by a
+*   looped breakpoint curve. This is a plain value type so it can be copied to the audio thread (see ProcessorHarness::setControlAutomation).
+*
+*   The curve is only ever evaluated at discrete times, so getValue() is a pure function of time and costs the same wherever it is called.
+*/
+struct AutomationLane
+{
+    enum class Shape
+    {
+        none = 0,
+        sine,
+        triangle,
+        square,
+        sawtooth,
+        breakpoints
+    };
+
+    /** A point on a breakpoint curve. The curve is linear between points and loops every (time of the last point) seconds. */
+    struct Breakpoint
+    {
+        double time = 0.0;      // Seconds
+        double value = 0.0;     // 0..1
+    };
+
+    /** Returns true if this lane moves its control (i.e. the manual value is overridden). */
+    [[nodiscard]] bool isActive() const noexcept;
+
+    /** Returns the control value (0..1) at a time (in seconds) since the harness was reset. The centre is the manual control value,
+     *  which LFOs are centred on (breakpoint curves ignore it). */
+    [[nodiscard]] double getValue (const double seconds, const double centre) const noexcept;
+
+    /** Returns the names of the shapes, in the order of the Shape enum (for populating a ComboBox). */
+    static StringArray getShapeNames();
+
+    /** Parses breakpoints from text of the form "time:value, time:value, ...". Points which can't be parsed are ignored and the result
+     *  is sorted by time. */
+    static std::vector<Breakpoint> parseBreakpoints (const String& text);
+
+    /** Formats breakpoints in the form accepted by parseBreakpoints(). */
+    static String breakpointsToString (const std::vector<Breakpoint>& points);
+
+    Shape shape = Shape::none;
+    double rate = 1.0;                      // LFO frequency (Hz)
+    double depth = 0.25;                    // LFO deviation either side of the centre value
+    std::vector<Breakpoint> breakpoints {};
+};
+
+
+// ===========================================================================================
+//  Implementation
+// ===========================================================================================
+
+inline bool AutomationLane::isActive() const noexcept
+{
+    if (shape == Shape::breakpoints)
+        return !breakpoints.empty();
+    return shape != Shape::none;
+}
+
+inline double AutomationLane::getValue (const double seconds, const double centre) const noexcept
+{
+    if (shape == Shape::none)
+        return centre;
+
+    if (shape == Shape::breakpoints)
+    {
+        if (breakpoints.empty())
+            return centre;
+
+        const auto loopLength = breakpoints.back().time;
+        if (loopLength <= 0.0)
+            return breakpoints.back().value;
+
+        // Hold the first value until the first point, then interpolate between points
+        const auto t = std::fmod (seconds, loopLength);
+        const auto next = std::upper_bound (breakpoints.cbegin(), breakpoints.cend(), t,
+                                            [] (const double time, const Breakpoint& point) { return time < point.time; });
+        if (next == breakpoints.cbegin())
+            return next->value;
+        if (next == breakpoints.cend())
+            return breakpoints.back().value;
+
+        const auto& previous = *(next - 1);
+        const auto segmentLength = next->time - previous.time;
+        if (segmentLength <= 0.0)
+            return next->value;
+        return previous.value + (next->value - previous.value) * (t - previous.time) / segmentLength;
+    }
+
+    const auto phase = seconds * rate - std::floor (seconds * rate);
+    auto wave = 0.0;
+    switch (shape)
+    {
+        case Shape::sine:       wave = std::sin (MathConstants<double>::twoPi * phase); break;
+        case Shape::triangle:   wave = phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase; break;
+        case Shape::square:     wave = phase < 0.5 ? 1.0 : -1.0; break;
+        case Shape::sawtooth:   wave = 2.0 * phase - 1.0; break;
+        case Shape::none:
+        case Shape::breakpoints:
+        default:                break;
+    }
+    return jlimit (0.0, 1.0, centre + depth * wave);
+}
+
+inline StringArray AutomationLane::getShapeNames()
+{
+    return { "Off", "Sine LFO", "Triangle LFO", "Square LFO", "Sawtooth LFO", "Breakpoints" };
+}
+
+inline std::vector<AutomationLane::Breakpoint> AutomationLane::parseBreakpoints (const String& text)
+{
+    std::vector<Breakpoint> points;
+    for (const auto& token : StringArray::fromTokens (text, ",;", ""))
+    {
+        const auto separator = token.indexOfChar (':');
+        if (separator < 0)
+            continue;
+        const auto timeText = token.substring (0, separator).trim();
+        const auto valueText = token.substring (separator + 1).trim();
+        if (timeText.isEmpty() || valueText.isEmpty())
+            continue;
+        points.push_back ({ jmax (0.0, timeText.getDoubleValue()), jlimit (0.0, 1.0, valueText.getDoubleValue()) });
+    }
+    std::stable_sort (points.begin(), points.end(), [] (const Breakpoint& a, const Breakpoint& b) { return a.time < b.time; });
+    return points;
+}
+
+inline String AutomationLane::breakpointsToString (const std::vector<Breakpoint>& points)
+{
+    StringArray tokens;
+    for (const auto& point : points)
+        tokens.add (String (point.time, 3) + ":" + String (point.value, 3));
+    return tokens.joinIntoString (", ");
+}
@@ -34,13 +34,18 @@ public:
     /** Note that this clears then sets AudioProbes per channel - so it must be called before any attached classes attempt to add listeners to the AudioProbes. */
     void prepare (const dsp::ProcessSpec& spec) override;
 
-    void performProcessing (const int channel) override;
+    void performProcessing (const int channel, const float* data) override;
     
-    /** Copy frame of FFT frequency data */
-    void copyFrequencyFrame (float* dest, const int channel) const;
+    /** Copy frame of FFT frequency data. Returns false if no consistent frame could be copied (try again later). */
+    bool copyFrequencyFrame (float* dest, const int channel) const;
 
-    /** Copy frame of FFT phase data */
-	void copyPhaseFrame (float* dest, const int channel) const;
+    /** Copy frame of FFT phase data. Returns false if no consistent frame could be copied (try again later). */
+	bool copyPhaseFrame (float* dest, const int channel) const;
+
+    /** Lends the latest frame of FFT frequency data to the reader (a callable taking a const float*) without copying it.
+     *  See AudioProbe::readLatestFrame() for the constraints on the reader. */
+    template <typename FrameReader>
+    bool readFrequencyFrame (const int channel, FrameReader&& reader) const;
 
     /** Call this to choose a different windowing method (class is initialised with Hann) */
     void setWindowingMethod (dsp::WindowingFunction<float>::WindowingMethod);
@@ -117,11 +122,10 @@ void FftProcessor<Order>::prepare (const dsp::ProcessSpec& spec)
 }
 
 template <int Order>
-void FftProcessor<Order>::performProcessing (const int channel)
+void FftProcessor<Order>::performProcessing (const int channel, const float* data)
 {
     // Apply window to audio input
-    temp.copyFrom (0, 0, buffer.getReadPointer (channel), size);
-    FloatVectorOperations::multiply (temp.getWritePointer (0), window.getWritePointer (0), size);
+    FloatVectorOperations::multiply (temp.getWritePointer (0), data, window.getReadPointer (0), size);
 
     // Perform FFT
     fft.performFrequencyOnlyForwardTransform (temp.getWritePointer (0));
@@ -144,15 +148,22 @@ void FftProcessor<Order>::performProcessing (const int channel)
 }
 
 template <int Order>
-void FftProcessor<Order>::copyFrequencyFrame (float* dest, const int channel) const
+bool FftProcessor<Order>::copyFrequencyFrame (float* dest, const int channel) const
+{
+    return freqProbes[channel]->copyFrame(reinterpret_cast<FftFrame*>(dest));
+}
+
+template <int Order>
+bool FftProcessor<Order>::copyPhaseFrame (float* dest, const int channel) const
 {
-    freqProbes[channel]->copyFrame(reinterpret_cast<FftFrame*>(dest));
+	return phaseProbes[channel]->copyFrame (reinterpret_cast <FftFrame*> (dest));
 }
 
 template <int Order>
-void FftProcessor<Order>::copyPhaseFrame (float* dest, const int channel) const
+template <typename FrameReader>
+bool FftProcessor<Order>::readFrequencyFrame (const int channel, FrameReader&& reader) const
 {
-	phaseProbes[channel]->copyFrame (reinterpret_cast <FftFrame*> (dest));
+    return freqProbes[channel]->readLatestFrame ([&reader] (const FftFrame& frame) { reader (frame.f); });
 }
 
 template <int Order>
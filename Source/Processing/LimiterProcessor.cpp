@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    LimiterProcessor.cpp
+    Created: 17 Oct 2026 9:12:40pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#include "LimiterProcessor.h"
+
+void LimiterProcessor::setThresholdDb (const float newThresholdDb)
+{
+    threshold = Decibels::decibelsToGain (newThresholdDb);
+}
+void LimiterProcessor::setCeilingDb (const float newCeilingDb)
+{
+    ceiling = Decibels::decibelsToGain (newCeilingDb);
+}
+void LimiterProcessor::setReleaseTime (const float seconds)
+{
+    releaseTime = seconds;
+}
+void LimiterProcessor::setLookAheadTime (const float seconds)
+{
+    lookAheadTime.store (jlimit (0.0f, maxLookAheadTime, seconds));
+    lookAheadChanged.store (true);
+}
+int LimiterProcessor::getLatencyInSamples() const
+{
+    return lookAheadSamples;
+}
+float LimiterProcessor::readMaxGainReductionDb()
+{
+    return maxGainReductionDb.exchange (0.0f);
+}
+double LimiterProcessor::getCpuLoad() const
+{
+    return loadMeasurer.getLoadAsProportion();
+}
+void LimiterProcessor::prepare (const dsp::ProcessSpec& spec)
+{
+    numChannels = spec.numChannels;
+    maxBlockSize = static_cast<int> (spec.maximumBlockSize);
+    sampleRate = spec.sampleRate;
+
+    // The original hold timers each last 1/128 s, staggered by half that, so the peak is held for between 1/256 and 1/128 s
+    holdSamples = roundToInt (sampleRate / 128.0);
+    maxLookAheadSamples = roundToInt (maxLookAheadTime * sampleRate);
+    const auto maxWindowSize = jmax (holdSamples, maxLookAheadSamples + 1);
+    releaseFactor = static_cast<float> (exp (-3.0 / (sampleRate * jmax (releaseTime, 0.05f))));
+
+    // Allocate for the longest look-ahead, so it can be changed without preparing again
+    peakBuffer.allocate (static_cast<size_t> (maxBlockSize), false);
+    channelPeaks.allocate (static_cast<size_t> (maxBlockSize), false);
+    delayBuffer.setSize (static_cast<int> (numChannels), maxLookAheadSamples + maxBlockSize);
+    dequeValues.allocate (static_cast<size_t> (maxWindowSize), false);
+    dequePositions.allocate (static_cast<size_t> (maxWindowSize), false);
+    attackHistory.allocate (static_cast<size_t> (maxLookAheadSamples + 1), false);
+    loadMeasurer.reset (spec.sampleRate, maxBlockSize);
+
+    lookAheadChanged.store (false);
+    resetRequested.store (false);
+    updateLookAhead();
+    clearState();
+    maxGainReductionDb.store (0.0f);
+}
+void LimiterProcessor::process (const dsp::ProcessContextReplacing<float>& context)
+{
+    const auto& block = context.getOutputBlock();
+    const auto numSamples = static_cast<int> (block.getNumSamples());
+    jassert (numSamples <= maxBlockSize && block.getNumChannels() <= numChannels);
+    const AudioProcessLoadMeasurer::ScopedTimer timer (loadMeasurer, numSamples);
+
+    if (lookAheadChanged.exchange (false))
+    {
+        updateLookAhead();
+        clearState();
+    }
+    else if (resetRequested.exchange (false))
+    {
+        clearState();
+    }
+
+    findLinkedPeaks (block, numSamples);
+    const auto minGain = calculateGain (numSamples);
+
+    for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        auto* data = block.getChannelPointer (ch);
+        if (lookAheadSamples > 0)
+            delayChannel (data, static_cast<int> (ch), numSamples);
+        FloatVectorOperations::multiply (data, peakBuffer, numSamples);
+    }
+
+    const auto gainReductionDb = -Decibels::gainToDecibels (minGain);
+    if (gainReductionDb > maxGainReductionDb.load())
+        maxGainReductionDb.store (gainReductionDb);
+}
+void LimiterProcessor::reset()
+{
+    resetRequested.store (true);
+    maxGainReductionDb.store (0.0f);
+}
+void LimiterProcessor::findLinkedPeaks (const dsp::AudioBlock<float>& block, const int numSamples)
+{
+    if (block.getNumChannels() == 0)
+    {
+        FloatVectorOperations::clear (peakBuffer, numSamples);
+        return;
+    }
+    FloatVectorOperations::abs (peakBuffer, block.getChannelPointer (0), numSamples);
+    for (size_t ch = 1; ch < block.getNumChannels(); ++ch)
+    {
+        FloatVectorOperations::abs (channelPeaks, block.getChannelPointer (ch), numSamples);
+        FloatVectorOperations::max (peakBuffer, peakBuffer, channelPeaks, numSamples);
+    }
+}
+float LimiterProcessor::calculateGain (const int numSamples)
+{
+    for (auto i = 0; i < numSamples; ++i, ++samplePosition)
+    {
+        // Drop the oldest candidate once it leaves the window, and any candidates the new peak is at least as large as
+        const auto peak = peakBuffer[i];
+        if (dequeSize > 0 && dequePositions[dequeHead] <= samplePosition - windowSize)
+        {
+            dequeHead = (dequeHead + 1) % windowSize;
+            --dequeSize;
+        }
+        while (dequeSize > 0 && dequeValues[(dequeHead + dequeSize - 1) % windowSize] <= peak)
+            --dequeSize;
+        const auto tail = (dequeHead + dequeSize) % windowSize;
+        dequeValues[tail] = peak;
+        dequePositions[tail] = samplePosition;
+        ++dequeSize;
+
+        const auto heldPeak = dequeValues[dequeHead];
+        if (envelope < heldPeak)
+            envelope = heldPeak;
+        else
+            envelope = heldPeak + releaseFactor * (envelope - heldPeak);
+        peakBuffer[i] = envelope;
+    }
+
+    // Convert the envelope to gain (this loop vectorises)
+    for (auto i = 0; i < numSamples; ++i)
+        peakBuffer[i] = jmin (1.0f, threshold / jmax (peakBuffer[i], threshold));
+
+    if (lookAheadSamples > 0)
+        rampGain (numSamples);
+
+    const auto minGain = FloatVectorOperations::findMinimum (peakBuffer.get(), numSamples);
+    FloatVectorOperations::multiply (peakBuffer, ceiling / threshold, numSamples);
+    return minGain;
+}
+void LimiterProcessor::rampGain (const int numSamples)
+{
+    // Every gain in the window is at or below the gain needed for the peak entering it (as the hold window covers the look-ahead),
+    // so the average has reached it by the time that peak leaves the delay line
+    const auto scale = 1.0 / static_cast<double> (attackLength);
+    for (auto i = 0; i < numSamples; ++i)
+    {
+        const auto gain = peakBuffer[i];
+        attackSum += static_cast<double> (gain) - static_cast<double> (attackHistory[attackIndex]);
+        attackHistory[attackIndex] = gain;
+        if (++attackIndex == attackLength)
+            attackIndex = 0;
+        peakBuffer[i] = jmin (1.0f, static_cast<float> (attackSum * scale));
+    }
+}
+void LimiterProcessor::delayChannel (float* data, const int channel, const int numSamples)
+{
+    // The channel's history is followed by the input, the output is taken from the start, and the end becomes the next history
+    auto* history = delayBuffer.getWritePointer (channel);
+    FloatVectorOperations::copy (history + lookAheadSamples, data, numSamples);
+    FloatVectorOperations::copy (data, history, numSamples);
+    std::memmove (history, history + numSamples, static_cast<size_t> (lookAheadSamples) * sizeof (float));
+}
+void LimiterProcessor::updateLookAhead()
+{
+    lookAheadSamples = jmin (roundToInt (lookAheadTime.load() * sampleRate), maxLookAheadSamples);
+    windowSize = jmax (holdSamples, lookAheadSamples + 1);
+    attackLength = lookAheadSamples + 1;
+}
+void LimiterProcessor::clearState()
+{
+    envelope = 0.0f;
+    dequeHead = 0;
+    dequeSize = 0;
+    samplePosition = 0;
+    delayBuffer.clear();
+    FloatVectorOperations::fill (attackHistory.get(), 1.0f, attackLength);
+    attackIndex = 0;
+    attackSum = static_cast<double> (attackLength);
+}
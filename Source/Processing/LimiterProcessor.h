@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    LimiterProcessor.h
+    Created: 17 Oct 2026 9:12:40pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+/**
+*   Peak limiter with hold, exponential release and optional look-ahead, with the gain linked across channels.
+*
+*   This is the MGA JS limiter (C) Michael Gruhn 2008 restructured to work a block at a time. The peak magnitude across channels is
+*   found with vectorised abs/max passes, then held with an exact sliding-window maximum (a monotonic deque, so it costs amortised O(1)
+*   per sample whatever the hold time) in place of the original pair of staggered hold timers. The envelope recursion is the only
+*   per-sample loop, and the gain it yields is applied with one vector multiply per channel.
+*
+*   Without look-ahead the attack is instant. With look-ahead, the audio is delayed by the look-ahead time, the hold window is extended
+*   to cover it and the gain is smoothed by a moving average over the look-ahead window. This ramps the gain down linearly over the
+*   look-ahead time, reaching the required reduction exactly when the peak reaches the output. The look-ahead adds the same amount of
+*   latency and can be changed while processing (up to maxLookAheadTime); the change is applied at the start of the next block.
+*
+*   The processor measures its own CPU load and keeps the maximum gain reduction for metering. reset() may be called from any thread
+*   (the state is cleared at the start of the next block).
+*/
+class LimiterProcessor final : public dsp::ProcessorBase
+{
+public:
+    LimiterProcessor() = default;
+    ~LimiterProcessor() override = default;
+
+    /** Sets the level above which the limiter reduces the gain. */
+    void setThresholdDb (const float newThresholdDb);
+
+    /** Sets the output level that peaks are limited to (make-up gain is the ceiling less the threshold). */
+    void setCeilingDb (const float newCeilingDb);
+
+    /** Sets the release time (applied at prepare). */
+    void setReleaseTime (const float seconds);
+
+    /** Sets the look-ahead time, which is also the latency. This can be called from any thread (the delay line is cleared when the
+     *  change is applied at the start of the next block). */
+    void setLookAheadTime (const float seconds);
+
+    /** The longest look-ahead time allowed (buffers are allocated for this at prepare). */
+    static constexpr float maxLookAheadTime = 0.02f;
+
+    /** Gets the look-ahead in samples at the prepared sample rate. */
+    [[nodiscard]] int getLatencyInSamples() const;
+
+    /** Gets the largest gain reduction (as a positive number of dB) since this was last called. */
+    [[nodiscard]] float readMaxGainReductionDb();
+
+    /** Gets the proportion of the available processing time used by this processor (averaged by the JUCE load measurer). */
+    [[nodiscard]] double getCpuLoad() const;
+
+    void prepare (const dsp::ProcessSpec& spec) override;
+    void process (const dsp::ProcessContextReplacing<float>& context) override;
+    void reset() override;
+
+private:
+
+    /** Finds the peak magnitude across channels for each sample of the input (into peakBuffer). */
+    void findLinkedPeaks (const dsp::AudioBlock<float>& block, const int numSamples);
+
+    /** Turns peakBuffer into the gain to apply to each sample (in place) and returns the minimum gain reduction factor. */
+    float calculateGain (const int numSamples);
+
+    /** Smooths the gain in peakBuffer (in place) with a moving average over the look-ahead window. */
+    void rampGain (const int numSamples);
+
+    /** Delays a channel by the look-ahead time (in place). */
+    void delayChannel (float* data, const int channel, const int numSamples);
+
+    /** Sets the look-ahead, hold window and attack ramp lengths for the current look-ahead time. */
+    void updateLookAhead();
+
+    /** Clears the envelope, hold window, attack ramp and delay line. */
+    void clearState();
+
+    float threshold = Decibels::decibelsToGain (-0.5f);
+    float ceiling = Decibels::decibelsToGain (-0.2f);
+    float releaseTime = 0.2f;
+    std::atomic <float> lookAheadTime { 0.0f };
+    std::atomic <bool> lookAheadChanged { false };
+    std::atomic <bool> resetRequested { false };
+
+    size_t numChannels = 0;
+    int maxBlockSize = 0;
+    double sampleRate = 44100.0;
+    int holdSamples = 1;
+    int maxLookAheadSamples = 0;
+    int lookAheadSamples = 0;
+    int windowSize = 1;                     // Hold time (or look-ahead, if longer) in samples
+    float releaseFactor = 0.0f;
+    float envelope = 0.0f;
+    HeapBlock <float> peakBuffer{};         // Peak magnitude for each sample, then the gain for each sample
+    HeapBlock <float> channelPeaks{};
+    AudioBuffer <float> delayBuffer;        // Look-ahead history followed by the input for each channel
+
+    // Attack ramp: the last (look-ahead + 1) gains, and their sum (in double to limit the drift of the running sum)
+    HeapBlock <float> attackHistory{};
+    int attackLength = 1;
+    int attackIndex = 0;
+    double attackSum = 1.0;
+
+    // Sliding-window maximum: a ring buffer of candidate peaks, in decreasing order of magnitude and increasing sample position
+    HeapBlock <float> dequeValues{};
+    HeapBlock <int64> dequePositions{};
+    int dequeHead = 0;
+    int dequeSize = 0;
+    int64 samplePosition = 0;
+
+    AudioProcessLoadMeasurer loadMeasurer;
+    std::atomic <float> maxGainReductionDb { 0.0f };
+
+public:
+    // Declare non-copyable, non-movable
+    LimiterProcessor (const LimiterProcessor&) = delete;
+    LimiterProcessor& operator= (const LimiterProcessor&) = delete;
+    LimiterProcessor (LimiterProcessor&& other) = delete;
+    LimiterProcessor& operator=(LimiterProcessor&& other) = delete;
+};
@@ -31,6 +31,14 @@ size_t PeakMeterProcessor::getNumChannels () const
 {
     return numChannels;
 }
+void PeakMeterProcessor::getLevelsDb (float* destination, const int numDestinationChannels) const
+{
+    const auto numToCopy = jmin (numDestinationChannels, static_cast<int> (numChannels));
+    for (auto ch = 0; ch < numToCopy; ++ch)
+        destination[ch] = Decibels::gainToDecibels (envelopeContinuation[ch].load (std::memory_order_relaxed));
+    for (auto ch = jmax (0, numToCopy); ch < numDestinationChannels; ++ch)
+        destination[ch] = noSignalDbLevel;
+}
 void PeakMeterProcessor::prepare (const dsp::ProcessSpec& spec)
 {
 	numChannels = spec.numChannels;
@@ -39,23 +47,57 @@ void PeakMeterProcessor::prepare (const dsp::ProcessSpec& spec)
     
     const auto releaseTime = 0.650f * static_cast<float> (spec.sampleRate); // 650 msec (as per PPM spec)
     releaseTimeConstant =  1.0f - exp (-1.0f / releaseTime);
+
+    // While nothing exceeds the envelope, after n samples env = decay^n * env + sum over i of (releaseTimeConstant * decay^(n - 1 - i) * |x[i]|)
+    const auto decay = 1.0f - releaseTimeConstant;
+    releasePowers.allocate (subBlockSize + 1, false);
+    releaseWeights.allocate (subBlockSize, false);
+    for (auto n = 0; n <= subBlockSize; ++n)
+        releasePowers[n] = std::pow (decay, static_cast<float> (n));
+    for (auto i = 0; i < subBlockSize; ++i)
+        releaseWeights[i] = releaseTimeConstant * releasePowers[subBlockSize - 1 - i];
 }
 void PeakMeterProcessor::process (const dsp::ProcessContextReplacing<float>& context)
 {
     jassert (numChannels == context.getInputBlock().getNumChannels());
+    const auto numSamples = static_cast<int> (context.getInputBlock().getNumSamples());
 	for (auto ch = 0; ch < static_cast<int> (numChannels); ++ch)
 	{
         const auto* channelBuffer = context.getInputBlock().getChannelPointer(static_cast<int> (ch));
         auto env = envelopeContinuation[ch].load();
         // Calculate envelope over the block, but only keep last envelope sample as the meter refresh rate
         // should be slower than the block processing rate
-        for (size_t i=0; i < context.getInputBlock().getNumSamples(); i++)
+        for (auto start = 0; start < numSamples; start += subBlockSize)
         {
-            const auto x = fabsf (channelBuffer[i]) + antiDenormalFloat;
-            if (x > env)
-                env = x; // Instant attack
-            else
-                env += (releaseTimeConstant * (x - env));
+            // A partial sub-block uses the weights for the end of a full sub-block
+            const auto* x = channelBuffer + start;
+            const auto n = jmin (subBlockSize, numSamples - start);
+            const auto* w = releaseWeights + (subBlockSize - n);
+            auto weightedSum = 0.0f;
+            const auto peakMagnitude = findPeakAndWeightedSum (x, w, n, weightedSum);
+            const auto peak = peakMagnitude + antiDenormalFloat;
+
+            // If nothing attacks, the envelope is just released over the whole sub-block
+            const auto released = env * releasePowers[n] + weightedSum + antiDenormalFloat * (1.0f - releasePowers[n]);
+
+            // The envelope can't fall below its fully decayed value within the sub-block, so if the peak doesn't exceed that
+            // then the whole sub-block is in release
+            if (peak <= jmax (env * releasePowers[n], antiDenormalFloat))
+            {
+                env = released;
+                continue;
+            }
+
+            // Otherwise the envelope is set by the last occurrence of the peak (if it attacks at all), then released over the
+            // remaining samples. Earlier attacks are always overtaken by the peak, and later samples are below it.
+            auto peakIndex = n - 1;
+            while (fabsf (x[peakIndex]) != peakMagnitude)
+                --peakIndex;
+            auto tailSum = 0.0f;
+            for (auto i = peakIndex + 1; i < n; ++i)
+                tailSum += w[i] * fabsf (x[i]);
+            const auto tailPower = releasePowers[n - 1 - peakIndex];
+            env = jmax (released, peak * tailPower + tailSum + antiDenormalFloat * (1.0f - tailPower));
 	    }
         envelopeContinuation[ch].store (env);
 	}
@@ -64,6 +106,38 @@ void PeakMeterProcessor::reset ()
 {
     envelopeContinuation.clear (numChannels);
 }
+float PeakMeterProcessor::findPeakAndWeightedSum (const float* data, const float* sampleWeights, const int numSamples, float& weightedSum)
+{
+    // Accumulate in independent lanes so that the compiler can vectorise the loop without reordering any one sum
+    constexpr auto numLanes = 8;
+    float peakLanes[numLanes] = {};
+    float sumLanes[numLanes] = {};
+    auto i = 0;
+    for (; i + numLanes <= numSamples; i += numLanes)
+    {
+        for (auto k = 0; k < numLanes; ++k)
+        {
+            const auto magnitude = std::abs (data[i + k]);
+            peakLanes[k] = magnitude > peakLanes[k] ? magnitude : peakLanes[k];
+            sumLanes[k] += sampleWeights[i + k] * magnitude;
+        }
+    }
+
+    auto peak = 0.0f;
+    weightedSum = 0.0f;
+    for (; i < numSamples; ++i)
+    {
+        const auto magnitude = std::abs (data[i]);
+        peak = jmax (peak, magnitude);
+        weightedSum += sampleWeights[i] * magnitude;
+    }
+    for (auto k = 0; k < numLanes; ++k)
+    {
+        peak = jmax (peak, peakLanes[k]);
+        weightedSum += sumLanes[k];
+    }
+    return peak;
+}
 
 float VUMeterProcessor::getLevel (const int channelNumber) const
 {
@@ -86,6 +160,14 @@ size_t VUMeterProcessor::getNumChannels () const
 {
     return numChannels;
 }
+void VUMeterProcessor::getLevelsDb (float* destination, const int numDestinationChannels) const
+{
+    const auto numToCopy = jmin (numDestinationChannels, static_cast<int> (numChannels));
+    for (auto ch = 0; ch < numToCopy; ++ch)
+        destination[ch] = Decibels::gainToDecibels (sqrtf (envelopeContinuation[ch].load (std::memory_order_relaxed)));
+    for (auto ch = jmax (0, numToCopy); ch < numDestinationChannels; ++ch)
+        destination[ch] = noSignalDbLevel;
+}
 void VUMeterProcessor::prepare (const dsp::ProcessSpec& spec)
 {
 	numChannels = spec.numChannels;
@@ -94,22 +176,34 @@ void VUMeterProcessor::prepare (const dsp::ProcessSpec& spec)
     
     const auto responseTime = 0.600f * static_cast<float> (spec.sampleRate); // 600 msec (similar to K system)
     timeConstant =  1.0f - exp (-1.0f / responseTime);
+
+    // After n samples, env = decay^n * env + sum over i of (timeConstant * decay^(n - 1 - i) * x[i]^2)
+    const auto decay = 1.0f - timeConstant;
+    decayPowers.allocate (subBlockSize + 1, false);
+    weights.allocate (subBlockSize, false);
+    for (auto n = 0; n <= subBlockSize; ++n)
+        decayPowers[n] = std::pow (decay, static_cast<float> (n));
+    for (auto i = 0; i < subBlockSize; ++i)
+        weights[i] = timeConstant * decayPowers[subBlockSize - 1 - i];
 }
 void VUMeterProcessor::process (const dsp::ProcessContextReplacing<float>& context)
 {
     jassert (numChannels == context.getInputBlock().getNumChannels());
+    const auto numSamples = static_cast<int> (context.getInputBlock().getNumSamples());
+    const auto antiDenormalSquared = antiDenormalFloat * antiDenormalFloat;
 	for (auto ch = 0; ch < static_cast<int> (numChannels); ++ch)
 	{
         const auto* channelBuffer = context.getInputBlock().getChannelPointer(static_cast<int> (ch));
         auto env = envelopeContinuation[ch].load();
         // Calculate envelope over the block, but only keep last envelope sample as the meter refresh rate
         // should be slower than the block processing rate
-        for (size_t i=0; i < context.getInputBlock().getNumSamples(); i++)
+        for (auto start = 0; start < numSamples; start += subBlockSize)
         {
-            // Calculate envelope on RMS values
-            const auto x = channelBuffer[i] * channelBuffer[i] + antiDenormalFloat * antiDenormalFloat;
-            // Attack & release time are the same for this meter
-            env += (timeConstant * (x - env));
+            // Attack & release time are the same for this meter, so the envelope is linear in the squared samples
+            // (a partial sub-block uses the weights for the end of a full sub-block)
+            const auto n = jmin (subBlockSize, numSamples - start);
+            const auto weightedSum = weightedSumOfSquares (channelBuffer + start, weights + (subBlockSize - n), n);
+            env = env * decayPowers[n] + weightedSum + antiDenormalSquared * (1.0f - decayPowers[n]);
 	    }
         envelopeContinuation[ch].store (env);
 	}
@@ -118,6 +212,23 @@ void VUMeterProcessor::reset ()
 {
     envelopeContinuation.clear (numChannels);
 }
+float VUMeterProcessor::weightedSumOfSquares (const float* data, const float* sampleWeights, const int numSamples)
+{
+    // Accumulate in independent lanes so that the compiler can vectorise the loop without reordering any one sum
+    constexpr auto numLanes = 8;
+    float lanes[numLanes] = {};
+    auto i = 0;
+    for (; i + numLanes <= numSamples; i += numLanes)
+        for (auto k = 0; k < numLanes; ++k)
+            lanes[k] += sampleWeights[i + k] * data[i + k] * data[i + k];
+
+    auto sum = 0.0f;
+    for (; i < numSamples; ++i)
+        sum += sampleWeights[i] * data[i] * data[i];
+    for (auto k = 0; k < numLanes; ++k)
+        sum += lanes[k];
+    return sum;
+}
 
 long ClipCounterProcessor::getNumClipEvents(const int channelNumber) const
 {
@@ -159,55 +270,468 @@ void ClipCounterProcessor::prepare (const dsp::ProcessSpec& spec)
     maxClipLength.allocate (numChannels, true);
     numClippedSamples.allocate (numChannels, true);
     clipLengthContinuation.allocate (numChannels, true);
+    resetRequested.store (false);
 }
 void ClipCounterProcessor::process (const dsp::ProcessContextReplacing<float>& context)
 {
     jassert (numChannels == context.getInputBlock().getNumChannels());
+    if (resetRequested.exchange (false))
+        clearCounts();
     
-    const auto numSamples = context.getInputBlock().getNumSamples();
+    const auto numSamples = static_cast<int> (context.getInputBlock().getNumSamples());
 	for (auto ch = 0; ch < static_cast<int> (numChannels); ++ch)
 	{
         // Pointer to samples for this channel
         const auto* x = context.getInputBlock().getChannelPointer(static_cast<int> (ch));
 
-        for (size_t i=0; i < numSamples; i++)
+        // Most blocks don't clip at all, in which case any clip event from the previous block has ended
+        const auto range = FloatVectorOperations::findMinAndMax (x, numSamples);
+        if (! isClipped (range.getStart()) && ! isClipped (range.getEnd()))
         {
-            // Check if this sample is clipped
-            if (isClipped (x[i]))
-            {
-                numClippedSamples[ch] += 1;
-                if (clipLengthContinuation[ch] == 0)
-                {
-                    // We just started a new clip event
-	                numClipEvents[ch] += 1;
-                }
-                else
-                {
-                    // Clip had previously started and is still continuing
-                    if (clipLengthContinuation[ch].load() > maxClipLength[ch].load())
-                        maxClipLength[ch] = clipLengthContinuation[ch].load();                    
-                }
-                clipLengthContinuation[ch] += 1;
-            }
-            else
-            {
-                // Reset continuation
-                clipLengthContinuation[ch].store (0);
-            }
+            clipLengthContinuation[ch] = 0;
+            continue;
         }
+
+        // Count runs of clipped samples on local state (without branching on each sample)
+        auto runLength = clipLengthContinuation[ch];
+        auto clippedSamples = 0L;
+        auto clipEvents = 0L;
+        auto longestRun = maxClipLength[ch].load (std::memory_order_relaxed);
+        for (auto i = 0; i < numSamples; ++i)
+        {
+            const auto clipped = static_cast<long> (isClipped (x[i]));
+            clippedSamples += clipped;
+            clipEvents += clipped & static_cast<long> (runLength == 0);   // We just started a new clip event
+            runLength = (runLength + 1) * clipped;                        // Reset continuation if this sample isn't clipped
+            longestRun = jmax (longestRun, runLength);
+        }
+        clipLengthContinuation[ch] = runLength;
+
+        // Publish the results for this block
+        numClippedSamples[ch].fetch_add (clippedSamples);
+        numClipEvents[ch].fetch_add (clipEvents);
+        maxClipLength[ch].store (longestRun);
 	}
 }
 void ClipCounterProcessor::reset()
+{
+    // The GUI calls this while audio is running, so leave the state to be cleared at the start of the next block (which also clears any
+    // counts the current block publishes after this), but clear the published counts now in case there isn't a next block for a while
+    resetRequested.store (true);
+    for (auto ch = 0; ch < static_cast<int> (numChannels); ++ch)
+    {
+        numClipEvents[ch].store (0);
+        maxClipLength[ch].store (0);
+        numClippedSamples[ch].store (0);
+    }
+}
+void ClipCounterProcessor::clearCounts()
 {
     for (auto ch = 0; ch < static_cast<int>(numChannels); ++ch)
     {
 	    numClipEvents[ch].store (0);
         maxClipLength[ch].store (0);
         numClippedSamples[ch].store (0);
-        clipLengthContinuation[ch].store (0);
+        clipLengthContinuation[ch] = 0;
     }
 }
 inline bool ClipCounterProcessor::isClipped (const float amplitude)
 {
     return (amplitude > 1.0f || amplitude < -1.0f);
 }
+
+float TruePeakMeterProcessor::getMaxLevelDb (const int channelNumber) const
+{
+    if (channelNumber >= 0 && channelNumber < static_cast<int> (numChannels))
+        return Decibels::gainToDecibels (maxLevels[channelNumber].load(), noSignalDbLevel);
+    else
+        return noSignalDbLevel;
+}
+double TruePeakMeterProcessor::getCpuLoad() const
+{
+    return loadMeasurer.getLoadAsProportion();
+}
+size_t TruePeakMeterProcessor::getNumChannels() const
+{
+    return numChannels;
+}
+void TruePeakMeterProcessor::prepare (const dsp::ProcessSpec& spec)
+{
+    numChannels = spec.numChannels;
+    maxBlockSize = static_cast<int> (spec.maximumBlockSize);
+
+    // Windowed sinc, centred so that the first phase falls on the original samples (and so isn't needed)
+    constexpr auto numTaps = oversamplingFactor * numTapsPerPhase;
+    constexpr auto centre = numTaps / 2;
+    HeapBlock<double> prototype (numTaps, true);
+    for (auto n = 0; n < numTaps; ++n)
+    {
+        const auto t = static_cast<double> (n - centre) / static_cast<double> (oversamplingFactor);
+        const auto sinc = n == centre ? 1.0 : std::sin (MathConstants<double>::pi * t) / (MathConstants<double>::pi * t);
+        const auto window = 0.5 + 0.5 * std::cos (MathConstants<double>::pi * static_cast<double> (n - centre) / static_cast<double> (centre)); // Hann
+        prototype[n] = sinc * window;
+    }
+    coefficients.allocate ((oversamplingFactor - 1) * numTapsPerPhase, false);
+    for (auto phase = 1; phase < oversamplingFactor; ++phase)
+    {
+        // Normalise each phase for unity gain at DC
+        auto sum = 0.0;
+        for (auto k = 0; k < numTapsPerPhase; ++k)
+            sum += prototype[k * oversamplingFactor + phase];
+        for (auto k = 0; k < numTapsPerPhase; ++k)
+            coefficients[(phase - 1) * numTapsPerPhase + (numTapsPerPhase - 1 - k)] = static_cast<float> (prototype[k * oversamplingFactor + phase] / sum);
+    }
+
+    inputBuffer.setSize (static_cast<int> (numChannels), historySize + maxBlockSize);
+    interpolated.allocate (static_cast<size_t> (maxBlockSize), false);
+    maxLevels.allocate (numChannels, true);
+    loadMeasurer.reset (spec.sampleRate, maxBlockSize);
+    resetRequested.store (false);
+    clearLevels();
+}
+void TruePeakMeterProcessor::process (const dsp::ProcessContextReplacing<float>& context)
+{
+    jassert (numChannels == context.getInputBlock().getNumChannels());
+    const auto numSamples = static_cast<int> (context.getInputBlock().getNumSamples());
+    const AudioProcessLoadMeasurer::ScopedTimer timer (loadMeasurer, numSamples);
+    if (resetRequested.exchange (false))
+        clearLevels();
+
+    // Blocks larger than expected are processed in chunks
+    for (auto start = 0; start < numSamples; start += maxBlockSize)
+        processChunk (context.getInputBlock(), static_cast<size_t> (start), jmin (maxBlockSize, numSamples - start));
+}
+void TruePeakMeterProcessor::processChunk (const dsp::AudioBlock<float>& block, const size_t startSample, const int numSamples)
+{
+	for (auto ch = 0; ch < static_cast<int> (numChannels); ++ch)
+	{
+        // Append the input to the history, so that each tap is a contiguous run of the buffer
+        auto* buffer = inputBuffer.getWritePointer (ch);
+        FloatVectorOperations::copy (buffer + historySize, block.getChannelPointer (static_cast<size_t> (ch)) + startSample, numSamples);
+
+        // The first phase is the input itself (delayed by the filter's latency)
+        const auto samplePeak = FloatVectorOperations::findMinAndMax (buffer, numSamples);
+        auto peak = jmax (-samplePeak.getStart(), samplePeak.getEnd());
+
+        for (auto phase = 1; phase < oversamplingFactor; ++phase)
+        {
+            const auto* c = coefficients + (phase - 1) * numTapsPerPhase;
+            FloatVectorOperations::multiply (interpolated, buffer, c[0], numSamples);
+            for (auto k = 1; k < numTapsPerPhase; ++k)
+                FloatVectorOperations::addWithMultiply (interpolated, buffer + k, c[k], numSamples);
+
+            const auto phasePeak = FloatVectorOperations::findMinAndMax (interpolated, numSamples);
+            peak = jmax (peak, -phasePeak.getStart(), phasePeak.getEnd());
+        }
+
+        // Keep the end of the input as history for the next block (the ranges overlap for blocks shorter than the history)
+        std::memmove (buffer, buffer + numSamples, sizeof (float) * historySize);
+
+        if (peak > maxLevels[ch].load())
+            maxLevels[ch].store (peak);
+	}
+}
+void TruePeakMeterProcessor::reset()
+{
+    // The GUI calls this while audio is running, so leave the state to be cleared at the start of the next block, but clear the
+    // published levels now so the reset shows while audio is stopped or held
+    resetRequested.store (true);
+    for (auto ch = 0; ch < static_cast<int> (numChannels); ++ch)
+        maxLevels[ch].store (0.0f);
+}
+void TruePeakMeterProcessor::clearLevels()
+{
+    inputBuffer.clear();
+    for (auto ch = 0; ch < static_cast<int> (numChannels); ++ch)
+        maxLevels[ch].store (0.0f);
+}
+
+float LoudnessMeterProcessor::getMomentaryLoudness() const
+{
+    return momentaryLoudness.load();
+}
+float LoudnessMeterProcessor::getShortTermLoudness() const
+{
+    return shortTermLoudness.load();
+}
+float LoudnessMeterProcessor::getIntegratedLoudness() const
+{
+    return integratedLoudness.load();
+}
+float LoudnessMeterProcessor::getLoudnessRange() const
+{
+    return loudnessRange.load();
+}
+float LoudnessMeterProcessor::getNoSignalLoudness() const
+{
+    return noSignalLoudness;
+}
+void LoudnessMeterProcessor::resetIntegration()
+{
+    integrationResetRequested.store (true);
+}
+size_t LoudnessMeterProcessor::getNumChannels() const
+{
+    return numChannels;
+}
+void LoudnessMeterProcessor::prepare (const dsp::ProcessSpec& spec)
+{
+    numChannels = spec.numChannels;
+
+    channelPointers.allocate (numChannels, true);
+    channelWeights.allocate (numChannels, false);
+    channelEnergies.allocate (numChannels, true);
+    shelfState1.allocate (numChannels, true);
+    shelfState2.allocate (numChannels, true);
+    highPassState1.allocate (numChannels, true);
+    highPassState2.allocate (numChannels, true);
+    hopEnergies.allocate (numHopsShortTerm, true);
+    blockCounts.allocate (numHistogramBins, true);
+    blockEnergies.allocate (numHistogramBins, true);
+    shortTermCounts.allocate (numHistogramBins, true);
+    shortTermEnergies.allocate (numHistogramBins, true);
+
+    // Surround channels are weighted by +1.5 dB and the LFE channel is excluded (BS.1770-4 table 3)
+    for (size_t ch = 0; ch < numChannels; ++ch)
+        channelWeights[ch] = 1.0;
+    if (numChannels == 6)
+    {
+        channelWeights[3] = 0.0;
+        channelWeights[4] = 1.41;
+        channelWeights[5] = 1.41;
+    }
+
+    // K-weighting filter coefficients for the sample rate, derived from the analogue prototypes of the BS.1770 filters
+    // (these give the coefficients tabulated in BS.1770 at 48 kHz)
+    const auto fs = spec.sampleRate;
+    {
+        const auto f0 = 1681.974450955533;
+        const auto gainDb = 3.999843853973347;
+        const auto q = 0.7071752369554196;
+        const auto k = std::tan (MathConstants<double>::pi * f0 / fs);
+        const auto vh = std::pow (10.0, gainDb / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const auto f0 = 38.13547087602444;
+        const auto q = 0.5003270373238773;
+        const auto k = std::tan (MathConstants<double>::pi * f0 / fs);
+        const auto a0 = 1.0 + k / q + k * k;
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    hopSize = jmax (1, roundToInt (fs * 0.1));
+    reset();
+}
+void LoudnessMeterProcessor::process (const dsp::ProcessContextReplacing<float>& context)
+{
+    jassert (numChannels == context.getInputBlock().getNumChannels());
+
+    if (integrationResetRequested.exchange (false))
+        clearIntegration();
+
+    for (size_t ch = 0; ch < numChannels; ++ch)
+        channelPointers[ch] = context.getInputBlock().getChannelPointer (ch);
+
+    // Process the block in segments which end on hop boundaries
+    const auto numSamples = static_cast<int> (context.getInputBlock().getNumSamples());
+    auto start = 0;
+    while (start < numSamples)
+    {
+        const auto numToProcess = jmin (numSamples - start, hopSize - hopPosition);
+        filterAndAccumulate (start, numToProcess);
+        start += numToProcess;
+        hopPosition += numToProcess;
+        if (hopPosition == hopSize)
+            completeHop();
+    }
+}
+void LoudnessMeterProcessor::reset()
+{
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        channelEnergies[ch] = 0.0;
+        shelfState1[ch] = 0.0;
+        shelfState2[ch] = 0.0;
+        highPassState1[ch] = 0.0;
+        highPassState2[ch] = 0.0;
+    }
+
+    // Restart the 400 ms and 3 s windows, so they don't include anything from before the reset
+    hopPosition = 0;
+    hopIndex = 0;
+    numHops = 0;
+    for (auto h = 0; h < numHopsShortTerm; ++h)
+        hopEnergies[h] = 0.0;
+    momentaryLoudness.store (noSignalLoudness);
+    shortTermLoudness.store (noSignalLoudness);
+    resetIntegration();
+}
+void LoudnessMeterProcessor::filterAndAccumulate (const int startSample, const int numSamples)
+{
+    // The channel loop is innermost, so each operation is applied across all the channel lanes at once (the coefficients are shared)
+    const auto nc = static_cast<int> (numChannels);
+    for (auto i = startSample; i < startSample + numSamples; ++i)
+    {
+        for (auto ch = 0; ch < nc; ++ch)
+        {
+            const auto x = static_cast<double> (channelPointers[ch][i]);
+
+            const auto y = shelf.b0 * x + shelfState1[ch];
+            shelfState1[ch] = shelf.b1 * x - shelf.a1 * y + shelfState2[ch];
+            shelfState2[ch] = shelf.b2 * x - shelf.a2 * y;
+
+            const auto z = highPass.b0 * y + highPassState1[ch];
+            highPassState1[ch] = highPass.b1 * y - highPass.a1 * z + highPassState2[ch];
+            highPassState2[ch] = highPass.b2 * y - highPass.a2 * z;
+
+            channelEnergies[ch] += z * z;
+        }
+    }
+}
+void LoudnessMeterProcessor::completeHop()
+{
+    auto energy = 0.0;
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        energy += channelWeights[ch] * channelEnergies[ch];
+        channelEnergies[ch] = 0.0;
+    }
+    hopPosition = 0;
+    hopEnergies[hopIndex] = energy / static_cast<double> (hopSize);
+    hopIndex = (hopIndex + 1) % numHopsShortTerm;
+    ++numHops;
+
+    // Sum the most recent hops for the 400 ms and 3 s windows (there are few enough that a running sum isn't worth the drift)
+    auto momentaryEnergy = 0.0;
+    auto shortTermEnergy = 0.0;
+    for (auto h = 0; h < numHopsShortTerm; ++h)
+    {
+        const auto e = hopEnergies[(hopIndex + numHopsShortTerm - 1 - h) % numHopsShortTerm];
+        if (h < numHopsMomentary)
+            momentaryEnergy += e;
+        shortTermEnergy += e;
+    }
+    momentaryEnergy /= static_cast<double> (numHopsMomentary);
+    shortTermEnergy /= static_cast<double> (numHopsShortTerm);
+
+    // Gating blocks are 400 ms with 75% overlap, i.e. one per hop once a full window is available
+    if (numHops >= numHopsMomentary)
+    {
+        const auto loudness = toLoudness (momentaryEnergy);
+        momentaryLoudness.store (static_cast<float> (loudness));
+        if (loudness > absoluteGate)
+        {
+            const auto bin = getHistogramBin (loudness);
+            ++blockCounts[bin];
+            blockEnergies[bin] += momentaryEnergy;
+            updateIntegratedLoudness();
+        }
+    }
+
+    // Short-term loudness is sampled at 10 Hz for the loudness range (EBU Tech 3342)
+    if (numHops >= numHopsShortTerm)
+    {
+        const auto loudness = toLoudness (shortTermEnergy);
+        shortTermLoudness.store (static_cast<float> (loudness));
+        if (loudness > absoluteGate)
+        {
+            const auto bin = getHistogramBin (loudness);
+            ++shortTermCounts[bin];
+            shortTermEnergies[bin] += shortTermEnergy;
+            updateLoudnessRange();
+        }
+    }
+}
+void LoudnessMeterProcessor::clearIntegration()
+{
+    for (auto bin = 0; bin < numHistogramBins; ++bin)
+    {
+        blockCounts[bin] = 0;
+        blockEnergies[bin] = 0.0;
+        shortTermCounts[bin] = 0;
+        shortTermEnergies[bin] = 0.0;
+    }
+    integratedLoudness.store (noSignalLoudness);
+    loudnessRange.store (0.0f);
+}
+void LoudnessMeterProcessor::updateIntegratedLoudness()
+{
+    // Relative gate is 10 LU below the loudness of the blocks above the absolute gate
+    auto count = static_cast<int64> (0);
+    auto energy = 0.0;
+    for (auto bin = 0; bin < numHistogramBins; ++bin)
+    {
+        count += blockCounts[bin];
+        energy += blockEnergies[bin];
+    }
+    if (count == 0)
+        return;
+
+    const auto relativeGateBin = getHistogramBin (toLoudness (energy / static_cast<double> (count)) + integratedRelativeGate);
+    count = 0;
+    energy = 0.0;
+    for (auto bin = relativeGateBin; bin < numHistogramBins; ++bin)
+    {
+        count += blockCounts[bin];
+        energy += blockEnergies[bin];
+    }
+    if (count > 0)
+        integratedLoudness.store (static_cast<float> (toLoudness (energy / static_cast<double> (count))));
+}
+void LoudnessMeterProcessor::updateLoudnessRange()
+{
+    // Relative gate is 20 LU below the loudness of the short-term values above the absolute gate
+    auto count = static_cast<int64> (0);
+    auto energy = 0.0;
+    for (auto bin = 0; bin < numHistogramBins; ++bin)
+    {
+        count += shortTermCounts[bin];
+        energy += shortTermEnergies[bin];
+    }
+    if (count == 0)
+        return;
+
+    const auto relativeGateBin = getHistogramBin (toLoudness (energy / static_cast<double> (count)) + rangeRelativeGate);
+    count = 0;
+    for (auto bin = relativeGateBin; bin < numHistogramBins; ++bin)
+        count += shortTermCounts[bin];
+    if (count == 0)
+        return;
+
+    // Loudness range is the difference between the 10th and 95th percentiles of the gated short-term loudness
+    const auto lowCount = static_cast<int64> (0.10 * static_cast<double> (count));
+    const auto highCount = static_cast<int64> (0.95 * static_cast<double> (count));
+    auto lowBin = relativeGateBin;
+    auto highBin = relativeGateBin;
+    auto cumulative = static_cast<int64> (0);
+    for (auto bin = relativeGateBin; bin < numHistogramBins; ++bin)
+    {
+        // Find the bins holding the values at each percentile
+        if (shortTermCounts[bin] > 0 && cumulative <= lowCount)
+            lowBin = bin;
+        if (shortTermCounts[bin] > 0 && cumulative <= highCount)
+            highBin = bin;
+        cumulative += shortTermCounts[bin];
+    }
+    loudnessRange.store (static_cast<float> (static_cast<double> (highBin - lowBin) * histogramStep));
+}
+int LoudnessMeterProcessor::getHistogramBin (const double loudness) const
+{
+    return jlimit (0, numHistogramBins - 1, static_cast<int> ((loudness - absoluteGate) / histogramStep));
+}
+double LoudnessMeterProcessor::toLoudness (const double energy)
+{
+    // Offset of -0.691 dB compensates for the gain of the K-weighting filter at 1 kHz
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10 (energy) : -150.0;
+}
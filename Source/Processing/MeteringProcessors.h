@@ -16,6 +16,14 @@
 #include <mm_malloc.h>
 #endif
 
+/**
+*   Peak programme meter with instant attack and exponential release.
+*
+*   The envelope is computed a sub-block at a time. The peak magnitude and a weighted sum of the magnitudes are found in one vectorised
+*   pass, from which the release over the whole sub-block follows in closed form. If the peak attacks, the envelope is instead
+*   released from the last occurrence of the peak. This is equivalent to running the recursion on every sample to within 0.01 dB
+*   (the only approximation is that a sample just below the peak which follows it within the sub-block doesn't re-trigger the attack).
+*/
 class PeakMeterProcessor final : public dsp::ProcessorBase
 {
 public:
@@ -26,14 +34,23 @@ public:
     [[nodiscard]] float getLevelDb (const int channelNumber) const;
     [[nodiscard]] size_t getNumChannels() const;
 
+    /** Copies the levels of all channels in dB from the contiguous envelope store in one pass, so that a meter can refresh every
+     *  channel from a single snapshot. Channels beyond those being processed are set to no signal. */
+    void getLevelsDb (float* destination, const int numDestinationChannels) const;
+
     void prepare (const dsp::ProcessSpec& spec) override;
     void process (const dsp::ProcessContextReplacing<float>& context) override;
     void reset() override;
 
 private:
+    static float findPeakAndWeightedSum (const float* data, const float* sampleWeights, const int numSamples, float& weightedSum);
+
     size_t numChannels = 0;
     HeapBlock <std::atomic <float>> envelopeContinuation{};
 	float releaseTimeConstant = 0.0f;
+    static constexpr int subBlockSize = 32;
+    HeapBlock <float> releasePowers{};      // Release over n samples for n = 0 to subBlockSize
+    HeapBlock <float> releaseWeights{};     // Weight of each sample magnitude in the envelope at the end of a full sub-block (during release)
     const float antiDenormalFloat = 1e-15f;
     const float noSignalDbLevel = -150.0f;
 
@@ -45,6 +62,13 @@ public:
     PeakMeterProcessor& operator=(PeakMeterProcessor&& other) = delete;
 };
 
+/**
+*   RMS meter with the same attack and release time.
+*
+*   The envelope is a one-pole filter of the squared signal, so over a sub-block it is the decayed starting envelope plus a weighted
+*   sum of the squared samples. The sum is accumulated in independent lanes so that it vectorises, and is equivalent to the per-sample
+*   recursion to within rounding.
+*/
 class VUMeterProcessor final : public dsp::ProcessorBase
 {
 public:
@@ -55,14 +79,23 @@ public:
     [[nodiscard]] float getLevelDb (const int channelNumber) const;
     [[nodiscard]] size_t getNumChannels() const;
 
+    /** Copies the levels of all channels in dB from the contiguous envelope store in one pass, so that a meter can refresh every
+     *  channel from a single snapshot. Channels beyond those being processed are set to no signal. */
+    void getLevelsDb (float* destination, const int numDestinationChannels) const;
+
     void prepare (const dsp::ProcessSpec& spec) override;
     void process (const dsp::ProcessContextReplacing<float>& context) override;
     void reset() override;
 
 private:
+    static float weightedSumOfSquares (const float* data, const float* sampleWeights, const int numSamples);
+
     size_t numChannels = 0;
     HeapBlock <std::atomic <float>> envelopeContinuation{};
 	float timeConstant = 0.0f;
+    static constexpr int subBlockSize = 64;
+    HeapBlock <float> decayPowers{};        // Decay over n samples for n = 0 to subBlockSize
+    HeapBlock <float> weights{};            // Weight of each squared sample in the envelope at the end of a full sub-block
     const float antiDenormalFloat = 1e-15f;
     const float noSignalDbLevel = -150.0f;
 
@@ -74,6 +107,15 @@ public:
     VUMeterProcessor& operator=(VUMeterProcessor&& other) = delete;
 };
 
+/**
+*   Counts clipped samples and clip events (runs of consecutive clipped samples) for each channel.
+*
+*   Blocks without any clipped samples are detected with a vectorised min/max and skipped. Otherwise the runs are counted on local
+*   state, and the results are published to the atomics read by the GUI once per block.
+*
+*   reset() may be called from any thread. It clears the published counts straight away (so a reset shows even while audio is stopped),
+*   and requests that the rest of the state is cleared at the start of the next block.
+*/
 class ClipCounterProcessor final : public dsp::ProcessorBase
 {
 public:
@@ -108,8 +150,12 @@ private:
     HeapBlock <std::atomic <long>> numClipEvents{};
     HeapBlock <std::atomic <long>> maxClipLength{};
     HeapBlock <std::atomic <long>> numClippedSamples{};
-    // State variable so we can detect runs across multiple blocks
-    HeapBlock <std::atomic <long>> clipLengthContinuation{};
+    // State variable so we can detect runs across multiple blocks (only accessed by process() and prepare())
+    HeapBlock <long> clipLengthContinuation{};
+    std::atomic <bool> resetRequested { false };
+
+    /** Clears the counts and state (on the audio thread, or before processing starts). */
+    void clearCounts();
 
 public:
     // Declare non-copyable, non-movable
@@ -117,4 +163,165 @@ public:
     ClipCounterProcessor& operator= (const ClipCounterProcessor&) = delete;
     ClipCounterProcessor (VUMeterProcessor&& other) = delete;
     ClipCounterProcessor& operator=(ClipCounterProcessor&& other) = delete;
-};
\ No newline at end of file
+};
+
+/**
+*   True-peak meter as per ITU-R BS.1770-4 annex 2, which estimates the inter-sample peaks by interpolating the signal by 4x.
+*
+*   The interpolator is a polyphase windowed-sinc FIR (12 taps per phase). Each phase is computed over the whole block as a sum of
+*   vectorised multiply-adds of delayed copies of the input, rather than as an inner product per output sample. The first phase
+*   falls on the original samples, so it is just the sample peak.
+*
+*   The maximum level for each channel since the last reset is kept for compliance checks. The processor also measures its own CPU
+*   load. reset() may be called from any thread. It clears the published maximum levels straight away, and requests that the history
+*   is cleared at the start of the next block.
+*/
+class TruePeakMeterProcessor final : public dsp::ProcessorBase
+{
+public:
+	TruePeakMeterProcessor() = default;
+    ~TruePeakMeterProcessor() override = default;
+
+    /** Gets the maximum true-peak level since the last reset in dBTP. */
+    [[nodiscard]] float getMaxLevelDb (const int channelNumber) const;
+
+    /** Gets the proportion of the available processing time used by this processor (averaged by the JUCE load measurer). */
+    [[nodiscard]] double getCpuLoad() const;
+
+    [[nodiscard]] size_t getNumChannels() const;
+
+    void prepare (const dsp::ProcessSpec& spec) override;
+    void process (const dsp::ProcessContextReplacing<float>& context) override;
+    void reset() override;
+
+private:
+
+    void processChunk (const dsp::AudioBlock<float>& block, const size_t startSample, const int numSamples);
+
+    /** Clears the history and maximum levels (on the audio thread, or before processing starts). */
+    void clearLevels();
+
+    static constexpr int oversamplingFactor = 4;
+    static constexpr int numTapsPerPhase = 12;
+    static constexpr int historySize = numTapsPerPhase - 1;
+
+    size_t numChannels = 0;
+    int maxBlockSize = 0;
+    HeapBlock <float> coefficients{};       // Coefficients for each phase after the first (in reverse order, to line up with the input)
+    AudioBuffer <float> inputBuffer;        // History followed by the input for each channel
+    HeapBlock <float> interpolated{};
+    AudioProcessLoadMeasurer loadMeasurer;
+    std::atomic <bool> resetRequested { false };
+
+    // Values for output
+    HeapBlock <std::atomic <float>> maxLevels{};
+    const float noSignalDbLevel = -150.0f;
+
+public:
+    // Declare non-copyable, non-movable
+    TruePeakMeterProcessor (const TruePeakMeterProcessor&) = delete;
+    TruePeakMeterProcessor& operator= (const TruePeakMeterProcessor&) = delete;
+    TruePeakMeterProcessor (TruePeakMeterProcessor&& other) = delete;
+    TruePeakMeterProcessor& operator=(TruePeakMeterProcessor&& other) = delete;
+};
+
+
+/**
+*   Loudness meter as per ITU-R BS.1770-4 and EBU R128 / Tech 3342, measuring momentary (400 ms), short-term (3 s) and integrated
+*   loudness in LUFS, and the loudness range in LU.
+*
+*   The K-weighting filter is run across channel lanes (the filter state for each stage is held in one array per state variable),
+*   and the weighted energy is accumulated per 100 ms hop. The 400 ms and 3 s windows are sums over a preallocated ring of hop
+*   energies, and the gated measurements are calculated from preallocated histograms (with 0.1 LU bins), so nothing is allocated or
+*   stored per block on the audio thread.
+*
+*   Channel weights assume the JUCE order for 5.1 (L, R, C, LFE, Ls, Rs) when there are six channels; otherwise all channels are
+*   weighted equally.
+*/
+class LoudnessMeterProcessor final : public dsp::ProcessorBase
+{
+public:
+	LoudnessMeterProcessor() = default;
+    ~LoudnessMeterProcessor() override = default;
+
+    /** Gets the loudness over the last 400 ms in LUFS. */
+    [[nodiscard]] float getMomentaryLoudness() const;
+
+    /** Gets the loudness over the last 3 s in LUFS. */
+    [[nodiscard]] float getShortTermLoudness() const;
+
+    /** Gets the gated loudness since the integration was last reset in LUFS. */
+    [[nodiscard]] float getIntegratedLoudness() const;
+
+    /** Gets the loudness range since the integration was last reset in LU. */
+    [[nodiscard]] float getLoudnessRange() const;
+
+    /** Gets the level returned when there is no (or not yet enough) signal to measure. */
+    [[nodiscard]] float getNoSignalLoudness() const;
+
+    /** Restarts the integrated loudness and loudness range. This can be called from any thread (the integration is restarted at
+     *  the start of the next block). */
+    void resetIntegration();
+
+    [[nodiscard]] size_t getNumChannels() const;
+
+    void prepare (const dsp::ProcessSpec& spec) override;
+    void process (const dsp::ProcessContextReplacing<float>& context) override;
+    void reset() override;
+
+private:
+
+    struct BiquadCoefficients
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    void filterAndAccumulate (const int startSample, const int numSamples);
+    void completeHop();
+    void clearIntegration();
+    void updateIntegratedLoudness();
+    void updateLoudnessRange();
+    [[nodiscard]] int getHistogramBin (const double loudness) const;
+    [[nodiscard]] static double toLoudness (const double energy);
+
+    size_t numChannels = 0;
+    HeapBlock <const float*> channelPointers{};
+    HeapBlock <double> channelWeights{};
+    HeapBlock <double> channelEnergies{};   // Weighted energy accumulated over the current hop for each channel
+
+    // K-weighting filter (a high shelf followed by a high pass), with transposed direct form II state for each channel
+    BiquadCoefficients shelf, highPass;
+    HeapBlock <double> shelfState1{}, shelfState2{}, highPassState1{}, highPassState2{};
+
+    static constexpr int numHopsMomentary = 4;      // 400 ms
+    static constexpr int numHopsShortTerm = 30;     // 3 s
+    int hopSize = 0;
+    int hopPosition = 0;
+    HeapBlock <double> hopEnergies{};               // Ring of the mean square energy of the most recent hops
+    int hopIndex = 0;
+    int64 numHops = 0;
+
+    static constexpr double absoluteGate = -70.0;
+    static constexpr double integratedRelativeGate = -10.0;
+    static constexpr double rangeRelativeGate = -20.0;
+    static constexpr double histogramMaximum = 10.0;
+    static constexpr double histogramStep = 0.1;
+    static constexpr int numHistogramBins = 800;    // (histogramMaximum - absoluteGate) / histogramStep
+    HeapBlock <uint32> blockCounts{}, shortTermCounts{};
+    HeapBlock <double> blockEnergies{}, shortTermEnergies{};
+
+    // Values for output
+    std::atomic <float> momentaryLoudness { 0.0f };
+    std::atomic <float> shortTermLoudness { 0.0f };
+    std::atomic <float> integratedLoudness { 0.0f };
+    std::atomic <float> loudnessRange { 0.0f };
+    std::atomic <bool> integrationResetRequested { false };
+    const float noSignalLoudness = -150.0f;
+
+public:
+    // Declare non-copyable, non-movable
+    LoudnessMeterProcessor (const LoudnessMeterProcessor&) = delete;
+    LoudnessMeterProcessor& operator= (const LoudnessMeterProcessor&) = delete;
+    LoudnessMeterProcessor (LoudnessMeterProcessor&& other) = delete;
+    LoudnessMeterProcessor& operator=(LoudnessMeterProcessor&& other) = delete;
+};
@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    OversamplingHarness.cpp
+    Created: 17 Oct 2026 5:22:18pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#include "OversamplingHarness.h"
+
+OversamplingHarness::OversamplingHarness (std::unique_ptr<ProcessorHarness> processorToWrap, const int numberOfStages, const FilterType filterType)
+    : ProcessorHarness (processorToWrap ? processorToWrap->getNumControls() : 0),
+      processor (std::move (processorToWrap)),
+      numStages (jlimit (1, 3, numberOfStages)),
+      type (filterType)
+{
+    jassert (processor);
+    jassert (numberOfStages >= 1 && numberOfStages <= 3);
+    stageStatistics.resize (static_cast<size_t> (numStages));
+}
+void OversamplingHarness::prepare (const dsp::ProcessSpec& spec)
+{
+    const auto specHasChanged = spec.numChannels != preparedSpec.numChannels
+                             || spec.maximumBlockSize != preparedSpec.maximumBlockSize
+                             || static_cast<int> (spec.sampleRate) != static_cast<int> (preparedSpec.sampleRate);
+    if (specHasChanged)
+        std::fill (stageStatistics.begin(), stageStatistics.end(), StageStatistics());
+    preparedSpec = spec;
+
+    // Each stage is a separate 2x oversampler so that we can time them individually
+    stages.clear();
+    stageInputBlocks.assign (static_cast<size_t> (numStages), dsp::AudioBlock<float>());
+    auto blockSize = static_cast<size_t> (spec.maximumBlockSize);
+    for (auto k = 0; k < numStages; ++k)
+    {
+        auto stage = std::make_unique<dsp::Oversampling<float>> (static_cast<size_t> (spec.numChannels), 1, type, true, false);
+        stage->initProcessing (blockSize);
+        stages.push_back (std::move (stage));
+        blockSize *= 2;
+    }
+
+    const auto factor = static_cast<uint32> (getOversamplingFactor());
+    processor->prepareHarness ({ spec.sampleRate * factor, spec.maximumBlockSize * factor, spec.numChannels });
+}
+void OversamplingHarness::process (const dsp::ProcessContextReplacing<float>& context)
+{
+    for (auto i = 0; i < getNumControls(); ++i)
+        processor->setControlValue (i, getSmoothedControlValue (i));
+
+    auto block = context.getOutputBlock();
+    for (size_t k = 0; k < stages.size(); ++k)
+    {
+        const auto start = Time::getMillisecondCounterHiRes();
+        stageInputBlocks[k] = block;
+        block = stages[k]->processSamplesUp (block);
+        stageStatistics[k].upDurationSum += Time::getMillisecondCounterHiRes() - start;
+    }
+
+    const dsp::ProcessContextReplacing<float> oversampledContext (block);
+    processor->processHarness (oversampledContext);
+
+    for (auto k = stages.size(); k-- > 0;)
+    {
+        const auto start = Time::getMillisecondCounterHiRes();
+        stages[k]->processSamplesDown (stageInputBlocks[k]);
+        stageStatistics[k].downDurationSum += Time::getMillisecondCounterHiRes() - start;
+        stageStatistics[k].count++;
+    }
+}
+void OversamplingHarness::reset()
+{
+    for (auto& stage : stages)
+        stage->reset();
+    processor->resetHarness();
+}
+String OversamplingHarness::getProcessorName()
+{
+    return processor->getProcessorName() + " (" + String (getOversamplingFactor()) + "x)";
+}
+String OversamplingHarness::getControlName (const int index)
+{
+    return processor->getControlName (index);
+}
+double OversamplingHarness::getDefaultControlValue (const int index)
+{
+    return processor->getDefaultControlValue (index);
+}
+String OversamplingHarness::queryStatisticsReport() const
+{
+    auto report = String (getOversamplingFactor()) + "x oversampling ("
+                + (type == FilterType::filterHalfBandPolyphaseIIR ? "polyphase IIR" : "FIR equiripple")
+                + "), latency " + String (getLatencyInSamples(), 2) + " samples";
+
+    // Average time per block for each stage (in microseconds)
+    for (size_t k = 0; k < stageStatistics.size(); ++k)
+    {
+        const auto& stats = stageStatistics[k];
+        if (stats.count > 0.0)
+            report << "\nStage " << static_cast<int> (k + 1) << " (" << (1 << (k + 1)) << "x): up "
+                   << String (stats.upDurationSum * 1000.0 / stats.count, 2) << ", down "
+                   << String (stats.downDurationSum * 1000.0 / stats.count, 2) << " microseconds per block";
+    }
+    if (processor->queryProcessingDurationNumSamples() > 0.0)
+        report << "\n" << processor->getProcessorName() << ": "
+               << String (processor->queryProcessingDurationAverage() * 1000.0, 2) << " microseconds per block";
+
+    const auto processorReport = processor->queryStatisticsReport();
+    if (processorReport.isNotEmpty())
+        report << "\n" << processorReport;
+    return report;
+}
+void OversamplingHarness::resetStatistics()
+{
+    ProcessorHarness::resetStatistics();
+    std::fill (stageStatistics.begin(), stageStatistics.end(), StageStatistics());
+    processor->resetStatistics();
+}
+int OversamplingHarness::getOversamplingFactor() const noexcept
+{
+    return 1 << numStages;
+}
+double OversamplingHarness::getLatencyInSamples() const
+{
+    // Each stage reports its latency at its own input rate
+    auto latency = 0.0;
+    for (size_t k = 0; k < stages.size(); ++k)
+        latency += static_cast<double> (stages[k]->getLatencyInSamples()) / static_cast<double> (1 << k);
+    return latency;
+}
+std::unique_ptr<ProcessorHarness> OversamplingHarness::createInstance() const
+{
+    auto wrappedInstance = processor->createInstance();
+    if (!wrappedInstance)
+        return nullptr;
+    return std::make_unique<OversamplingHarness> (std::move (wrappedInstance), numStages, type);
+}
+ProcessorHarness* OversamplingHarness::getWrappedProcessor() const noexcept
+{
+    return processor.get();
+}
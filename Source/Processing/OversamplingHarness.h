@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    OversamplingHarness.h
+    Created: 17 Oct 2026 5:22:18pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ProcessorHarness.h"
+
+/**
+ * Wraps another ProcessorHarness so that it runs at 2x, 4x or 8x the sample rate, which lets you compare the aliasing of a nonlinear
+ * processor against the cost of oversampling it (e.g. new OversamplingHarness (std::make_unique<MyProcessor>(), 2) runs it at 4x).
+ *
+ * Each factor of two is a separate half-band stage (polyphase IIR or equiripple FIR, as in dsp::Oversampling). The wrapped processor
+ * is prepared with a correspondingly scaled ProcessSpec and keeps its own statistics. The time taken by each stage (up and down) is
+ * measured separately and reported, along with the latency, by queryStatisticsReport().
+ *
+ * The wrapped processor's controls are exposed as this processor's controls, and their smoothed values are passed on every block.
+ */
+class OversamplingHarness : public ProcessorHarness
+{
+public:
+    using FilterType = dsp::Oversampling<float>::FilterType;
+
+    /** Creates a wrapper which oversamples by 2^numberOfStages (1 to 3 stages). */
+    OversamplingHarness (std::unique_ptr<ProcessorHarness> processorToWrap,
+                         const int numberOfStages,
+                         const FilterType filterType = FilterType::filterHalfBandPolyphaseIIR);
+    ~OversamplingHarness() override = default;
+
+    void prepare (const dsp::ProcessSpec& spec) override;
+    void process (const dsp::ProcessContextReplacing<float>& context) override;
+    void reset() override;
+
+    String getProcessorName() override;
+    String getControlName (const int index) override;
+    double getDefaultControlValue (const int index) override;
+    [[nodiscard]] String queryStatisticsReport() const override;
+    void resetStatistics() override;
+    [[nodiscard]] std::unique_ptr<ProcessorHarness> createInstance() const override;
+
+    /** Returns the oversampling factor (2, 4 or 8). */
+    [[nodiscard]] int getOversamplingFactor() const noexcept;
+
+    /** Returns the latency added by the oversampling filters, in samples at the base rate (the wrapped processor may add more). */
+    [[nodiscard]] double getLatencyInSamples() const;
+
+    /** Returns the wrapped processor. */
+    [[nodiscard]] ProcessorHarness* getWrappedProcessor() const noexcept;
+
+private:
+
+    /** Time taken by one stage, summed over the blocks processed since statistics were reset (in milliseconds). */
+    struct StageStatistics
+    {
+        double upDurationSum = 0.0;
+        double downDurationSum = 0.0;
+        double count = 0.0;
+    };
+
+    std::unique_ptr<ProcessorHarness> processor;
+    const int numStages;
+    const FilterType type;
+    std::vector<std::unique_ptr<dsp::Oversampling<float>>> stages;
+    std::vector<dsp::AudioBlock<float>> stageInputBlocks;   // The block passed into each stage, which it downsamples back into
+    std::vector<StageStatistics> stageStatistics;
+    dsp::ProcessSpec preparedSpec {};                       // So the stage statistics can be reset if the spec changes
+};
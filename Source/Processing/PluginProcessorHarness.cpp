@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+    PluginProcessorHarness.cpp
+    Created: 17 Oct 2026 6:48:40pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#include "PluginProcessorHarness.h"
+
+PluginProcessorHarness::PluginProcessorHarness (const File& libraryToLoad)
+    : PluginProcessorHarness (libraryToLoad, loadLibrary (libraryToLoad), true)
+{ }
+PluginProcessorHarness::PluginProcessorHarness (const File& libraryToLoad, std::shared_ptr<Library> initialLibrary, const bool watchForChanges)
+    : ProcessorHarness (initialLibrary->isLoaded ? static_cast<int> (initialLibrary->descriptor.numControls) : 0),
+      libraryFile (libraryToLoad),
+      lastModificationTime (libraryToLoad.getLastModificationTime()),
+      library (std::move (initialLibrary))
+{
+    host.context = this;
+    host.countRecalculation = countRecalculationCallback;
+
+    controlValues.allocate (static_cast<size_t> (getNumControls()) + 1, true);
+    controlsChanged.allocate (static_cast<size_t> (getNumControls()) + 1, true);
+
+    if (library->isLoaded)
+        instance = library->descriptor.create (&host);
+    else
+        lastError = library->error;
+
+    if (watchForChanges)
+        startTimer (1000);
+}
+PluginProcessorHarness::~PluginProcessorHarness()
+{
+    stopTimer();
+    if (instance != nullptr)
+        library->descriptor.destroy (instance);
+}
+void PluginProcessorHarness::prepare (const dsp::ProcessSpec& spec)
+{
+    const SpinLock::ScopedLockType lock (processorLock);
+    preparedSpec = { spec.sampleRate, spec.maximumBlockSize, spec.numChannels };
+    channelPointers.allocate (spec.numChannels, true);
+    isPrepared = true;
+    if (instance != nullptr)
+        library->descriptor.prepare (instance, &preparedSpec);
+}
+void PluginProcessorHarness::process (const dsp::ProcessContextReplacing<float>& context)
+{
+    const auto& outputBlock = context.getOutputBlock();
+
+    // Don't wait if the processor is being swapped - just skip this block
+    const SpinLock::ScopedTryLockType lock (processorLock);
+    if (!lock.isLocked() || instance == nullptr)
+    {
+        outputBlock.clear();
+        return;
+    }
+
+    for (auto i = 0; i < getNumControls(); ++i)
+    {
+        controlValues[i] = getSmoothedControlValue (i);
+        controlsChanged[i] = (forceControlsChanged || hasControlChanged (i)) ? 1 : 0;
+    }
+    forceControlsChanged = false;
+
+    const auto numChannels = static_cast<uint32_t> (jmin (outputBlock.getNumChannels(), static_cast<size_t> (preparedSpec.numChannels)));
+    for (uint32_t ch = 0; ch < numChannels; ++ch)
+        channelPointers[ch] = outputBlock.getChannelPointer (ch);
+
+    const DsptbProcessBlock block { channelPointers, numChannels, static_cast<uint32_t> (outputBlock.getNumSamples()), controlValues, controlsChanged };
+    library->descriptor.process (instance, &block);
+}
+void PluginProcessorHarness::reset()
+{
+    const SpinLock::ScopedLockType lock (processorLock);
+    if (instance != nullptr)
+        library->descriptor.reset (instance);
+}
+String PluginProcessorHarness::getProcessorName()
+{
+    return library->isLoaded ? library->name : libraryFile.getFileNameWithoutExtension() + " (not loaded)";
+}
+String PluginProcessorHarness::getControlName (const int index)
+{
+    return library->controlNames[index];
+}
+double PluginProcessorHarness::getDefaultControlValue (const int index)
+{
+    jassert (isPositiveAndBelow (index, static_cast<int> (library->defaultControlValues.size())));
+    return library->defaultControlValues[static_cast<size_t> (index)];
+}
+String PluginProcessorHarness::queryStatisticsReport() const
+{
+    auto report = "Loaded from " + libraryFile.getFullPathName() + " (reloaded " + String (numReloads) + " times)";
+    if (lastError.isNotEmpty())
+        report << "\nLast error: " << lastError;
+    return report;
+}
+std::unique_ptr<ProcessorHarness> PluginProcessorHarness::createInstance() const
+{
+    // Share the library rather than loading another copy (the constructor is private, hence no make_unique)
+    return std::unique_ptr<ProcessorHarness> (new PluginProcessorHarness (libraryFile, library, false));
+}
+bool PluginProcessorHarness::reload()
+{
+    auto newLibrary = loadLibrary (libraryFile);
+    if (!newLibrary->isLoaded)
+    {
+        lastError = newLibrary->error;
+        return false;
+    }
+    if (newLibrary->descriptor.numControls != getNumControls())
+    {
+        lastError = "The number of controls has changed (from " + String (getNumControls()) + " to "
+                  + String (newLibrary->descriptor.numControls) + "), so the testbench needs to be restarted";
+        return false;
+    }
+
+    auto* newInstance = newLibrary->descriptor.create (&host);
+    if (newInstance == nullptr)
+    {
+        lastError = "The processor could not be created";
+        return false;
+    }
+
+    {
+        // Replay the prepare state and swap processors (the audio thread skips blocks while we hold the lock)
+        const SpinLock::ScopedLockType lock (processorLock);
+        if (isPrepared)
+            newLibrary->descriptor.prepare (newInstance, &preparedSpec);
+        newLibrary->descriptor.reset (newInstance);
+        std::swap (instance, newInstance);
+        std::swap (library, newLibrary);
+        forceControlsChanged = true;
+    }
+
+    // Destroy the old processor and release the old library now that the audio thread can't be using them (it's unloaded once any
+    // instances made from this harness are finished with it too)
+    if (newInstance != nullptr)
+        newLibrary->descriptor.destroy (newInstance);
+    newLibrary.reset();
+
+    lastError = String();
+    numReloads++;
+    return true;
+}
+bool PluginProcessorHarness::isLoaded() const noexcept
+{
+    return instance != nullptr;
+}
+String PluginProcessorHarness::getLastError() const
+{
+    return lastError;
+}
+std::shared_ptr<PluginProcessorHarness::Library> PluginProcessorHarness::loadLibrary (const File& file)
+{
+    auto library = std::make_shared<Library>();
+    if (!file.existsAsFile())
+    {
+        library->error = "Library not found: " + file.getFullPathName();
+        return library;
+    }
+
+    // Load a uniquely named copy, so that the original can be rebuilt while it's loaded (and the OS doesn't hand back the old code)
+    library->loadedCopy = File::getSpecialLocation (File::tempDirectory)
+                            .getNonexistentChildFile (file.getFileNameWithoutExtension() + "_loaded", file.getFileExtension(), false);
+    if (!file.copyFileTo (library->loadedCopy))
+    {
+        library->error = "Unable to copy library to " + library->loadedCopy.getFullPathName();
+        return library;
+    }
+    if (!library->dynamicLibrary.open (library->loadedCopy.getFullPathName()))
+    {
+        library->error = "Unable to load library: " + file.getFullPathName();
+        return library;
+    }
+
+    const auto getDescriptor = reinterpret_cast<DsptbGetProcessorDescriptorFunction> (library->dynamicLibrary.getFunction (DSPTB_DESCRIPTOR_FUNCTION_NAME));
+    const auto* descriptor = getDescriptor != nullptr ? getDescriptor() : nullptr;
+    if (descriptor == nullptr)
+    {
+        library->error = String ("Library does not export ") + DSPTB_DESCRIPTOR_FUNCTION_NAME;
+        return library;
+    }
+    if (descriptor->apiVersion != DSPTB_PLUGIN_API_VERSION)
+    {
+        library->error = "Library was built for API version " + String (static_cast<int> (descriptor->apiVersion))
+                       + " (expected " + String (DSPTB_PLUGIN_API_VERSION) + ")";
+        return library;
+    }
+    if (descriptor->numControls < 0 || descriptor->getControlName == nullptr || descriptor->getDefaultControlValue == nullptr
+        || descriptor->create == nullptr || descriptor->destroy == nullptr || descriptor->prepare == nullptr
+        || descriptor->process == nullptr || descriptor->reset == nullptr)
+    {
+        library->error = "Library has an incomplete processor descriptor";
+        return library;
+    }
+
+    // Copy everything the GUI needs, so it never has to call into the library
+    library->descriptor = *descriptor;
+    library->name = String::fromUTF8 (descriptor->name != nullptr ? descriptor->name : "Unnamed");
+    for (auto i = 0; i < descriptor->numControls; ++i)
+    {
+        const auto* controlName = descriptor->getControlName (i);
+        library->controlNames.add (controlName != nullptr ? String::fromUTF8 (controlName) : "Control " + String (i + 1));
+        library->defaultControlValues.push_back (jlimit (0.0, 1.0, descriptor->getDefaultControlValue (i)));
+    }
+    library->isLoaded = true;
+    return library;
+}
+void PluginProcessorHarness::countRecalculationCallback (void* context)
+{
+    static_cast<PluginProcessorHarness*> (context)->countRecalculation();
+}
+void PluginProcessorHarness::timerCallback()
+{
+    const auto modificationTime = libraryFile.getLastModificationTime();
+    if (modificationTime == lastModificationTime)
+        return;
+
+    // Wait until the file has stopped changing (i.e. the build has finished) before reloading it
+    if (modificationTime != pendingModificationTime)
+    {
+        pendingModificationTime = modificationTime;
+        return;
+    }
+    lastModificationTime = modificationTime;
+    reload();
+}
+
+PluginProcessorHarness::Library::~Library()
+{
+    dynamicLibrary.close();
+    if (loadedCopy != File())
+        loadedCopy.deleteFile();
+}
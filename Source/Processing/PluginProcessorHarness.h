@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    PluginProcessorHarness.h
+    Created: 17 Oct 2026 6:48:40pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ProcessorHarness.h"
+#include "ProcessorPluginApi.h"
+
+/**
+ * A ProcessorHarness which runs a processor loaded from a shared library (.so, .dylib or .dll) built against ProcessorPluginApi.h,
+ * so that the processor under test can be rebuilt without rebuilding (or restarting) the testbench.
+ *
+ * The library file is watched and reloaded automatically once it has been rebuilt. A uniquely named copy is loaded each time, so the
+ * original file can be overwritten while it's in use and the new code is always picked up. While the processor is being swapped the
+ * output is silent, and the new processor is prepared with the last ProcessSpec (and reset) before it processes any audio. The control
+ * values are kept, and every control is flagged as changed on the first block after a reload.
+ *
+ * The number of controls is fixed when the harness is created (as the GUI is built from it), so a reload which changes it is rejected.
+ *
+ * Instances made by createInstance() share the loaded library with the harness they were made from (rather than each loading a copy)
+ * and don't watch the file, so they keep running the code they were created with even if the original reloads.
+ */
+class PluginProcessorHarness : public ProcessorHarness, private Timer
+{
+public:
+    explicit PluginProcessorHarness (const File& libraryToLoad);
+    ~PluginProcessorHarness() override;
+
+    void prepare (const dsp::ProcessSpec& spec) override;
+    void process (const dsp::ProcessContextReplacing<float>& context) override;
+    void reset() override;
+
+    String getProcessorName() override;
+    String getControlName (const int index) override;
+    double getDefaultControlValue (const int index) override;
+    [[nodiscard]] String queryStatisticsReport() const override;
+    [[nodiscard]] std::unique_ptr<ProcessorHarness> createInstance() const override;
+
+    /** Reloads the library now (which happens automatically when the file changes). Call this from the message thread.
+     *  Returns false, keeping the current processor, if the library can't be loaded. */
+    bool reload();
+
+    /** Returns true if a processor is loaded. */
+    [[nodiscard]] bool isLoaded() const noexcept;
+
+    /** Returns a description of the last problem loading the library (or an empty string). */
+    [[nodiscard]] String getLastError() const;
+
+private:
+
+    /** A loaded copy of the library, and what we need to know about the processor it describes. */
+    struct Library
+    {
+        Library() = default;
+        ~Library();
+
+        File loadedCopy;
+        DynamicLibrary dynamicLibrary;
+        DsptbProcessorDescriptor descriptor {};
+        bool isLoaded = false;
+        String error;
+        String name;
+        StringArray controlNames;
+        std::vector<double> defaultControlValues;
+
+        JUCE_DECLARE_NON_COPYABLE (Library)
+    };
+
+    PluginProcessorHarness (const File& libraryToLoad, std::shared_ptr<Library> initialLibrary, const bool watchForChanges);
+
+    static std::shared_ptr<Library> loadLibrary (const File& file);
+    static void countRecalculationCallback (void* context);
+    void timerCallback() override;
+
+    File libraryFile;
+    Time lastModificationTime, pendingModificationTime;
+    std::shared_ptr<Library> library;       // Shared with any instances made from this one
+    void* instance = nullptr;
+    DsptbHost host {};
+
+    SpinLock processorLock;                 // Held while the processor is swapped, so that process() can skip the block
+    DsptbProcessSpec preparedSpec {};
+    bool isPrepared = false;
+    bool forceControlsChanged = false;
+    HeapBlock<float*> channelPointers;
+    HeapBlock<double> controlValues;
+    HeapBlock<uint8_t> controlsChanged;
+
+    String lastError;
+    int numReloads = 0;
+};
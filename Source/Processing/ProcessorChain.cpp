@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    ProcessorChain.cpp
+    Created: 17 Oct 2026 8:03:15pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#include "ProcessorChain.h"
+
+ProcessorChain::ProcessorChain (std::initializer_list<Slot> slotsToAdd)
+    : ProcessorChain (std::vector<Slot> (slotsToAdd))
+{
+}
+ProcessorChain::ProcessorChain (const std::vector<Slot>& slotsToAdd)
+    : ProcessorHarness (countControls (slotsToAdd))
+{
+    for (const auto& slot : slotsToAdd)
+    {
+        jassert (slot.processor != nullptr);
+        if (slot.processor == nullptr)
+            continue;
+
+        // The first processor can't be in parallel with anything
+        const auto connection = processors.empty() ? Connection::series : slot.connection;
+        if (connection == Connection::parallel)
+        {
+            groups.back().numSlots++;
+            hasParallelGroup = true;
+        }
+        else
+        {
+            groups.push_back ({ static_cast<int> (processors.size()), 1 });
+        }
+        processors.emplace_back (slot.processor);
+        connections.push_back (connection);
+    }
+}
+void ProcessorChain::prepare (const dsp::ProcessSpec& spec)
+{
+    // Parallel groups share one pair of buffers, so we only need them if there are any
+    if (hasParallelGroup)
+    {
+        groupInput = dsp::AudioBlock<float> (groupInputMemory, spec.numChannels, spec.maximumBlockSize);
+        branch = dsp::AudioBlock<float> (branchMemory, spec.numChannels, spec.maximumBlockSize);
+    }
+
+    for (auto& processor : processors)
+        processor->prepareHarness (spec);
+}
+void ProcessorChain::process (const dsp::ProcessContextReplacing<float>& context)
+{
+    auto controlIndex = 0;
+    for (auto& processor : processors)
+        for (auto i = 0; i < processor->getNumControls(); ++i)
+            processor->setControlValue (i, getSmoothedControlValue (controlIndex++));
+
+    auto block = context.getOutputBlock();
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+
+    for (const auto& group : groups)
+    {
+        auto* firstProcessor = processors[static_cast<size_t> (group.firstSlot)].get();
+        if (group.numSlots == 1)
+        {
+            processSlot (firstProcessor, block);
+            continue;
+        }
+
+        // Keep the group's input, process the first branch in place, then sum in the rest of the branches one at a time and average them
+        auto input = groupInput.getSubsetChannelBlock (0, numChannels).getSubBlock (0, numSamples);
+        input.copyFrom (block);
+        processSlot (firstProcessor, block);
+
+        for (auto s = group.firstSlot + 1; s < group.firstSlot + group.numSlots; ++s)
+        {
+            auto branchBlock = branch.getSubsetChannelBlock (0, numChannels).getSubBlock (0, numSamples);
+            branchBlock.copyFrom (input);
+            processSlot (processors[static_cast<size_t> (s)].get(), branchBlock);
+            block.add (branchBlock);
+        }
+        block.multiplyBy (1.0f / static_cast<float> (group.numSlots));
+    }
+}
+void ProcessorChain::reset()
+{
+    for (auto& processor : processors)
+        processor->resetHarness();
+}
+String ProcessorChain::getProcessorName()
+{
+    auto name = String ("Chain: ");
+    for (size_t s = 0; s < processors.size(); ++s)
+    {
+        if (s > 0)
+            name << (connections[s] == Connection::parallel ? " + " : " > ");
+        name << processors[s]->getProcessorName();
+    }
+    return name;
+}
+String ProcessorChain::getControlName (const int index)
+{
+    const auto [processor, controlIndex] = findControl (index);
+    const auto slot = std::find_if (processors.cbegin(), processors.cend(), [p = processor] (const auto& x) { return x.get() == p; }) - processors.cbegin();
+    return String (static_cast<int> (slot) + 1) + ": " + processor->getControlName (controlIndex);
+}
+double ProcessorChain::getDefaultControlValue (const int index)
+{
+    const auto [processor, controlIndex] = findControl (index);
+    return processor->getDefaultControlValue (controlIndex);
+}
+String ProcessorChain::queryStatisticsReport() const
+{
+    // Average time per block for each processor (in microseconds), and how much the chain adds to their total
+    auto report = String();
+    auto total = 0.0;
+    for (size_t s = 0; s < processors.size(); ++s)
+    {
+        const auto& processor = processors[s];
+        if (processor->queryProcessingDurationNumSamples() <= 0.0)
+            continue;
+        const auto average = processor->queryProcessingDurationAverage();
+        total += average;
+        report << (report.isEmpty() ? "" : "\n") << static_cast<int> (s + 1) << ": " << processor->getProcessorName() << " "
+               << String (average * 1000.0, 2) << " microseconds per block";
+    }
+    if (queryProcessingDurationNumSamples() > 0.0)
+        report << "\nSum of processors " << String (total * 1000.0, 2) << ", chain overhead "
+               << String ((queryProcessingDurationAverage() - total) * 1000.0, 2) << " microseconds per block";
+    return report;
+}
+void ProcessorChain::resetStatistics()
+{
+    ProcessorHarness::resetStatistics();
+    for (auto& processor : processors)
+        processor->resetStatistics();
+}
+std::unique_ptr<ProcessorHarness> ProcessorChain::createInstance() const
+{
+    // Every processor in the chain must be able to create an instance
+    std::vector<std::unique_ptr<ProcessorHarness>> instances;
+    for (const auto& processor : processors)
+    {
+        instances.push_back (processor->createInstance());
+        if (!instances.back())
+            return nullptr;
+    }
+
+    std::vector<Slot> slots;
+    for (size_t s = 0; s < instances.size(); ++s)
+        slots.push_back ({ instances[s].release(), connections[s] });
+    return std::unique_ptr<ProcessorHarness> (new ProcessorChain (slots));
+}
+int ProcessorChain::getNumProcessors() const noexcept
+{
+    return static_cast<int> (processors.size());
+}
+ProcessorHarness* ProcessorChain::getProcessor (const int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, getNumProcessors()));
+    return processors[static_cast<size_t> (index)].get();
+}
+int ProcessorChain::countControls (const std::vector<Slot>& slotsToCount)
+{
+    auto numControls = 0;
+    for (const auto& slot : slotsToCount)
+        if (slot.processor != nullptr)
+            numControls += slot.processor->getNumControls();
+    return numControls;
+}
+std::pair<ProcessorHarness*, int> ProcessorChain::findControl (const int index) const
+{
+    jassert (isPositiveAndBelow (index, getNumControls()));
+    auto remaining = index;
+    for (const auto& processor : processors)
+    {
+        if (remaining < processor->getNumControls())
+            return { processor.get(), remaining };
+        remaining -= processor->getNumControls();
+    }
+    return { processors.back().get(), 0 };
+}
+void ProcessorChain::processSlot (ProcessorHarness* processor, dsp::AudioBlock<float>& block)
+{
+    processor->processHarness (dsp::ProcessContextReplacing<float> (block));
+}
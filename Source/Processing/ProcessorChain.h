@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    ProcessorChain.h
+    Created: 17 Oct 2026 8:03:15pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ProcessorHarness.h"
+
+/**
+ * Runs any number of harnessed processors as one, so that a realistic chain can be measured in either processor slot (the benchmark
+ * reports the total alongside the time taken by each processor). Each processor is either in series with the one before it, or in
+ * parallel with it (i.e. fed the same input, with the outputs mixed at equal levels), for example:
+ *
+ *      new ProcessorChain ({ { new LpfExample() }, { new ThruExample(), ProcessorChain::Connection::parallel }, { new LpfExample() } })
+ *
+ * is an LPF, followed by an LPF and a straight-through path mixed together, followed by another LPF.
+ *
+ * The outputs of a parallel group are averaged (i.e. each branch is scaled by 1 / the number of branches) rather than just summed, so
+ * a group of unity gain branches has unity gain and doesn't push the chain's output towards clipping.
+ *
+ * Series processors run in place. The buffers needed by parallel groups are allocated in prepare() and reused by every group - one
+ * holds the group's input and the other is used by each branch after the first in turn - so there's no allocation while processing.
+ *
+ * The controls of all the processors are exposed as this processor's controls (in order), and their smoothed values are passed on
+ * every block.
+ */
+class ProcessorChain : public ProcessorHarness
+{
+public:
+    enum class Connection
+    {
+        series,
+        parallel
+    };
+
+    /** A processor (which the chain takes ownership of) and how it is connected to the one before it. */
+    struct Slot
+    {
+        ProcessorHarness* processor = nullptr;
+        Connection connection = Connection::series;
+    };
+
+    explicit ProcessorChain (std::initializer_list<Slot> slotsToAdd);
+    ~ProcessorChain() override = default;
+
+    void prepare (const dsp::ProcessSpec& spec) override;
+    void process (const dsp::ProcessContextReplacing<float>& context) override;
+    void reset() override;
+
+    String getProcessorName() override;
+    String getControlName (const int index) override;
+    double getDefaultControlValue (const int index) override;
+    [[nodiscard]] String queryStatisticsReport() const override;
+    void resetStatistics() override;
+    [[nodiscard]] std::unique_ptr<ProcessorHarness> createInstance() const override;
+
+    /** Returns the number of processors in the chain. */
+    [[nodiscard]] int getNumProcessors() const noexcept;
+
+    /** Returns one of the processors in the chain. */
+    [[nodiscard]] ProcessorHarness* getProcessor (const int index) const noexcept;
+
+private:
+
+    /** A run of processors which share an input and have their outputs summed (a single processor is in series). */
+    struct Group
+    {
+        int firstSlot = 0;
+        int numSlots = 0;
+    };
+
+    explicit ProcessorChain (const std::vector<Slot>& slotsToAdd);
+
+    static int countControls (const std::vector<Slot>& slotsToCount);
+
+    /** Finds the processor which a control belongs to. */
+    [[nodiscard]] std::pair<ProcessorHarness*, int> findControl (const int index) const;
+
+    static void processSlot (ProcessorHarness* processor, dsp::AudioBlock<float>& block);
+
+    std::vector<std::unique_ptr<ProcessorHarness>> processors;
+    std::vector<Connection> connections;
+    std::vector<Group> groups;
+    bool hasParallelGroup = false;
+
+    HeapBlock<char> groupInputMemory, branchMemory;
+    dsp::AudioBlock<float> groupInput, branch;
+};
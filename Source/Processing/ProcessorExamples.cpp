@@ -13,38 +13,43 @@
 LpfExample::LpfExample()
 : ProcessorHarness (2)
 {
-    init();
+    setControlSmoothingTime (0, 0.05);
+    setControlSmoothingTime (1, 0.02);
 }
 void LpfExample::prepare (const dsp::ProcessSpec & spec)
 {
-    numChannels = static_cast<int> (spec.numChannels);
-    freqConversionFactor = MathConstants<double>::pi / spec.sampleRate;
-    z1.allocate (numChannels, true);
-    z2.allocate (numChannels, true);
+    sampleRate = spec.sampleRate;
+    filter.prepare (static_cast<int> (spec.numChannels), 1, static_cast<int> (spec.maximumBlockSize));
+    gainRamp.allocate (spec.maximumBlockSize, false);
 }
 void LpfExample::process (const dsp::ProcessContextReplacing<float>& context)
 {
     jassert (context.getInputBlock().getNumChannels() == context.getOutputBlock().getNumChannels());
 
-    calculateCoefficients();
+    if (hasControlChanged (0))
+    {
+        calculateCoefficients();
+        countRecalculation();
+    }
+
+    const auto numSamples = static_cast<int> (context.getOutputBlock().getNumSamples());
+    const auto isGainRamping = getSmoothedControlRamp (1, gainRamp, numSamples);
+    const auto gain = getSmoothedControlValue (1);
+
+    filter.process (context);
 
     for (size_t ch = 0; ch <context.getOutputBlock().getNumChannels(); ++ch)
     {
-        auto* in = context.getInputBlock().getChannelPointer (ch);
         auto* out = context.getOutputBlock().getChannelPointer (ch);
-
-        for (size_t i = 0; i < context.getOutputBlock().getNumSamples(); i++)
-        {
-            const auto sample = static_cast<double> (in[i]) * a0 + z1[ch];
-            z1[ch] = static_cast<double> (in[i]) * a1 + z2[ch] - b1 * sample;
-            z2[ch] = static_cast<double> (in[i]) * a0 - b2 * sample;
-            out[i] = static_cast<float> (sample * getControlValue (1));
-        }
+        if (isGainRamping)
+            FloatVectorOperations::multiply (out, gainRamp, numSamples);
+        else if (gain != 1.0)
+            FloatVectorOperations::multiply (out, static_cast<float> (gain), numSamples);
     }
 }
 void LpfExample::reset()
 {
-   init();
+    filter.reset();
 }
 String LpfExample::getProcessorName()
 {
@@ -68,29 +73,15 @@ double LpfExample::getDefaultControlValue (const int index)
         default: return 0.0;
     }
 }
-void LpfExample::init()
+std::unique_ptr<ProcessorHarness> LpfExample::createInstance() const
 {
-    a0 = 1.0;
-    a1 = 0.0;
-    b1 = 0.0;
-    b2 = 0.0;
-    for (auto ch = 0; ch < numChannels; ++ch)
-    {
-        z1[ch] = 0.0;
-        z2[ch] = 0.0;
-    }
+    return std::make_unique<LpfExample>();
 }
 void LpfExample::calculateCoefficients()
 {
-    // We're logarithmically mapping the 0..1 range of the control to 10Hz..20kHz
-    const auto freq = pow (10.0, getControlValue (0) * 3.30103 + 1.0) * freqConversionFactor;
-    const auto k = tan (freq);
-    const auto kk = k * k;
-    const auto norm = 1.0 / (1.0 + k + kk);
-    a0 = kk * norm;
-    a1 = 2.0 * a0;
-    b1 = 2.0 * (kk - 1.0) * norm;
-    b2 = (1.0 - k + kk) * norm;
+    // We're logarithmically mapping the 0..1 range of the control to 10Hz..20kHz (kept below Nyquist at low sample rates)
+    const auto freq = jmin (pow (10.0, getSmoothedControlValue (0) * 3.30103 + 1.0), sampleRate * 0.49);
+    filter.setCoefficients (BiquadCascade<double>::Coefficients::makeLowPass (freq, sampleRate, 1.0));
 }
 
 
@@ -120,4 +111,8 @@ String ThruExample::getControlName (const int /*index*/)
 double ThruExample::getDefaultControlValue (const int /*index*/)
 {
     return 0.0;
-}
\ No newline at end of file
+}
+std::unique_ptr<ProcessorHarness> ThruExample::createInstance() const
+{
+    return std::make_unique<ThruExample>();
+}
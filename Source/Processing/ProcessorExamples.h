@@ -10,9 +10,17 @@
 
 #pragma once
 #include "ProcessorHarness.h"
+#include "BiquadCascade.h"
 
 /** 
  * Example processor implementing a low pass filter using a biquad.
+ *
+ * The filter runs on a double precision BiquadCascade (so channels are processed in SIMD lanes), which makes this a reference for
+ * building other filters on it. The frequency is smoothed with a per-block ramp and the coefficients are only recalculated when it
+ * changes. The gain is smoothed with a per-sample ramp.
+ *
+ * Note that the output is not bit-identical to the earlier scalar version of this filter: the coefficients are calculated with a
+ * different order of operations, so results can differ at the level of rounding error (and the cutoff is now clamped below Nyquist).
  */
 class LpfExample : public ProcessorHarness
 {
@@ -27,15 +35,14 @@ public:
     String getProcessorName() override;
     String getControlName (const int index) override;
     double getDefaultControlValue (const int index) override;
+    [[nodiscard]] std::unique_ptr<ProcessorHarness> createInstance() const override;
 
 private:
-    void init();
     void calculateCoefficients();
 
-    int numChannels = 0;
-    double freqConversionFactor = 0.0;
-    double a0 = 0.0, a1 = 0.0, b1 = 0.0, b2 = 0.0;
-    HeapBlock<double> z1, z2;
+    double sampleRate = 0.0;
+    HeapBlock<float> gainRamp;
+    BiquadCascade<double> filter;
 };
 
 
@@ -58,4 +65,5 @@ public:
     String getProcessorName() override;
     String getControlName (const int index) override;
     double getDefaultControlValue (const int index) override;
+    [[nodiscard]] std::unique_ptr<ProcessorHarness> createInstance() const override;
 };
\ No newline at end of file
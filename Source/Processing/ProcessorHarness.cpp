@@ -15,6 +15,9 @@ ProcessorHarness::ProcessorHarness (const int numberOfControlValues)
 {
     for (auto i = 0; i < numberOfControlValues; ++i)
         controlValues.emplace_back (0.0f);
+    controlSmoothers.resize (static_cast<size_t> (numberOfControlValues));
+    automationLanes.resize (static_cast<size_t> (numberOfControlValues));
+    automation.publish (automationLanes);
 }
 void ProcessorHarness::prepareHarness (const dsp::ProcessSpec& spec)
 {
@@ -28,9 +31,25 @@ void ProcessorHarness::prepareHarness (const dsp::ProcessSpec& spec)
         procDurationMax = 0.0;
         procDurationSum = 0.0;
         procDurationCount = 0.0;
+        recalculationCount = 0.0;
+        automationEventCount = 0.0;
     }
     currentSpec = spec;
 
+    for (auto& smoother : controlSmoothers)
+    {
+        smoother.rampLength = roundToInt (smoother.smoothingTime * spec.sampleRate);
+        smoother.renderedValue = -1.0;
+    }
+    controlsNeedInitialising = true;
+
+    // Allocate for the worst case of every control having an event at every interval
+    automationInterval = jmax (1, requestedAutomationInterval.get());
+    const auto maxEventsPerControl = static_cast<size_t> (spec.maximumBlockSize) / static_cast<size_t> (automationInterval) + 2;
+    controlEvents.clear();
+    controlEvents.reserve (controlSmoothers.size() * maxEventsPerControl);
+    automationPosition = 0;
+
     const auto start = Time::getMillisecondCounterHiRes();
 
 // =====================
@@ -45,13 +64,36 @@ void ProcessorHarness::prepareHarness (const dsp::ProcessSpec& spec)
 }
 void ProcessorHarness::processHarness (const dsp::ProcessContextReplacing<float>& context)
 {
-    const auto start = Time::getMillisecondCounterHiRes();
-    
-// =====================
-    process (context);
-// =====================
+    const auto numSamples = static_cast<int> (context.getOutputBlock().getNumSamples());
+    renderAutomation (automation.acquire(), numSamples);
+
+    // Split the block at each automation event, so the processor sees each new value from the sample it occurs at
+    auto duration = 0.0;
+    auto position = 0;
+    auto nextEvent = controlEvents.cbegin();
+    while (position < numSamples)
+    {
+        for (; nextEvent != controlEvents.cend() && nextEvent->sampleOffset <= position; ++nextEvent)
+            controlSmoothers[static_cast<size_t> (nextEvent->controlIndex)].automatedValue = nextEvent->value;
+
+        const auto end = nextEvent != controlEvents.cend() ? nextEvent->sampleOffset : numSamples;
+        updateControls (end - position);
+        if (position == 0 && end == numSamples)
+        {
+            duration += processAndTime (context);
+        }
+        else
+        {
+            auto subBlock = context.getOutputBlock().getSubBlock (static_cast<size_t> (position), static_cast<size_t> (end - position));
+            dsp::ProcessContextReplacing<float> subContext (subBlock);
+            subContext.isBypassed = context.isBypassed;
+            duration += processAndTime (subContext);
+        }
+        position = end;
+    }
+    automationEventCount += static_cast<double> (controlEvents.size());
+    automationPosition += numSamples;
 
-    const auto duration = Time::getMillisecondCounterHiRes() - start;
     if (duration<procDurationMin) procDurationMin = duration;
     if (duration>procDurationMax) procDurationMax = duration;
     procDurationSum += duration;
@@ -59,6 +101,11 @@ void ProcessorHarness::processHarness (const dsp::ProcessContextReplacing<float>
 }
 void ProcessorHarness::resetHarness ()
 {
+    controlsNeedInitialising = true;
+    automationPosition = 0;
+    for (auto& smoother : controlSmoothers)
+        smoother.renderedValue = -1.0;
+
     const auto start = Time::getMillisecondCounterHiRes();
 
 // =====================
@@ -89,6 +136,167 @@ float ProcessorHarness::getControlValueAsFloat (const int index) const
 {
     return static_cast<float> (getControlValue (index));
 }
+void ProcessorHarness::setControlSmoothingTime (const int index, const double seconds)
+{
+    jassert (index >= 0 && index < getNumControls());
+    auto& smoother = controlSmoothers[static_cast<size_t> (index)];
+    smoother.smoothingTime = jmax (0.0, seconds);
+    smoother.rampLength = roundToInt (smoother.smoothingTime * currentSpec.sampleRate);
+}
+bool ProcessorHarness::hasControlChanged (const int index) const
+{
+    jassert (index >= 0 && index < getNumControls());
+    return controlSmoothers[static_cast<size_t> (index)].changed;
+}
+bool ProcessorHarness::hasAnyControlChanged() const
+{
+    for (const auto& smoother : controlSmoothers)
+        if (smoother.changed)
+            return true;
+    return false;
+}
+double ProcessorHarness::getSmoothedControlValue (const int index) const
+{
+    jassert (index >= 0 && index < getNumControls());
+    return controlSmoothers[static_cast<size_t> (index)].current;
+}
+bool ProcessorHarness::getSmoothedControlRamp (const int index, float* destination, const int numSamples) const
+{
+    jassert (index >= 0 && index < getNumControls());
+    const auto& smoother = controlSmoothers[static_cast<size_t> (index)];
+    if (!smoother.changed)
+        return false;
+
+    const auto numRamped = jmin (numSamples, smoother.rampedSamples);
+    for (auto i = 0; i < numRamped; ++i)
+        destination[i] = static_cast<float> (smoother.start + smoother.step * static_cast<double> (i + 1));
+    FloatVectorOperations::fill (destination + numRamped, static_cast<float> (smoother.current), numSamples - numRamped);
+    return true;
+}
+void ProcessorHarness::countRecalculation() noexcept
+{
+    recalculationCount++;
+}
+double ProcessorHarness::queryRecalculationCount() const
+{
+    return recalculationCount;
+}
+void ProcessorHarness::setControlAutomation (const int index, const AutomationLane& lane)
+{
+    jassert (index >= 0 && index < getNumControls());
+    automationLanes[static_cast<size_t> (index)] = lane;
+    automation.publish (automationLanes);
+}
+AutomationLane ProcessorHarness::getControlAutomation (const int index) const
+{
+    jassert (index >= 0 && index < getNumControls());
+    return automationLanes[static_cast<size_t> (index)];
+}
+void ProcessorHarness::setAutomationInterval (const int numSamples)
+{
+    jassert (numSamples > 0);
+    requestedAutomationInterval.set (jmax (1, numSamples));
+}
+double ProcessorHarness::queryAutomationEventCount() const
+{
+    return automationEventCount;
+}
+void ProcessorHarness::updateControls (const int numSamples)
+{
+    for (size_t i = 0; i < controlSmoothers.size(); ++i)
+    {
+        auto& smoother = controlSmoothers[i];
+        const auto target = smoother.isAutomated ? smoother.automatedValue : controlValues[i].get();
+        smoother.start = smoother.current;
+        smoother.rampedSamples = 0;
+
+        if (controlsNeedInitialising)
+        {
+            // Jump straight to the value, but still flag it as changed so that anything derived from it is recalculated
+            smoother.target = target;
+            smoother.current = target;
+            smoother.samplesRemaining = 0;
+            smoother.changed = true;
+            continue;
+        }
+
+        if (target != smoother.target)
+        {
+            smoother.target = target;
+            if (smoother.rampLength > 0)
+            {
+                smoother.samplesRemaining = smoother.rampLength;
+                smoother.step = (target - smoother.current) / static_cast<double> (smoother.rampLength);
+            }
+            else
+            {
+                smoother.current = target;
+                smoother.samplesRemaining = 0;
+            }
+        }
+
+        if (smoother.samplesRemaining > 0)
+        {
+            smoother.rampedSamples = jmin (numSamples, smoother.samplesRemaining);
+            smoother.samplesRemaining -= smoother.rampedSamples;
+            if (smoother.samplesRemaining > 0)
+                smoother.current += smoother.step * static_cast<double> (smoother.rampedSamples);
+            else
+                smoother.current = smoother.target; // Avoid accumulated rounding errors
+        }
+
+        smoother.changed = smoother.current != smoother.start;
+    }
+    controlsNeedInitialising = false;
+}
+void ProcessorHarness::renderAutomation (const std::vector<AutomationLane>& lanes, const int numSamples)
+{
+    controlEvents.clear();
+    const auto gridOffset = static_cast<int> ((automationInterval - automationPosition % automationInterval) % automationInterval);
+
+    for (size_t i = 0; i < controlSmoothers.size() && i < lanes.size(); ++i)
+    {
+        auto& smoother = controlSmoothers[i];
+        const auto& lane = lanes[i];
+        smoother.isAutomated = lane.isActive();
+        if (!smoother.isAutomated)
+        {
+            smoother.renderedValue = -1.0; // So there's an event at the start of the next block it is active for
+            continue;
+        }
+
+        const auto centre = controlValues[i].get();
+        const auto addEvent = [&] (const int offset)
+        {
+            const auto seconds = static_cast<double> (automationPosition + offset) / currentSpec.sampleRate;
+            const auto value = lane.getValue (seconds, centre);
+            if (value != smoother.renderedValue && controlEvents.size() < controlEvents.capacity())
+            {
+                controlEvents.push_back ({ offset, static_cast<int> (i), value });
+                smoother.renderedValue = value;
+            }
+        };
+
+        // Events fall on a fixed grid (counted from the last reset), plus the start of the block when a lane is first activated
+        if (smoother.renderedValue < 0.0 && gridOffset != 0)
+            addEvent (0);
+        for (auto offset = gridOffset; offset < numSamples; offset += automationInterval)
+            addEvent (offset);
+    }
+
+    std::sort (controlEvents.begin(), controlEvents.end(),
+               [] (const ControlEvent& a, const ControlEvent& b) { return a.sampleOffset < b.sampleOffset; });
+}
+double ProcessorHarness::processAndTime (const dsp::ProcessContextReplacing<float>& context)
+{
+    const auto start = Time::getMillisecondCounterHiRes();
+
+// =====================
+    process (context);
+// =====================
+
+    return Time::getMillisecondCounterHiRes() - start;
+}
 dsp::ProcessSpec ProcessorHarness::getCurrentProcessSpec () const
 {
     return currentSpec;
@@ -199,4 +407,7 @@ void ProcessorHarness::resetStatistics()
     resetDurationMax = -1.0;
     resetDurationSum = 0.0;
     resetDurationCount = 0.0;
+
+    recalculationCount = 0.0;
+    automationEventCount = 0.0;
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioDataTransfer.h"
+#include "AutomationLane.h"
 
 /** 
  * Inherit from this and implement the virtual methods in order to create a customised ProcessorHarness.
@@ -43,6 +45,14 @@ public:
      *  NOTE - the controls are floats in the range 0..1.
      */
     virtual double getDefaultControlValue (const int index) = 0;
+
+    /** You can override this to return a description of any statistics your processor keeps (shown in the benchmark). */
+    [[nodiscard]] virtual String queryStatisticsReport() const { return {}; }
+
+    /** You can override this to create a new (unprepared) instance of your processor, e.g. return std::make_unique<MyProcessor>().
+     *  This allows several instances to be run at once (e.g. to stress test it). The caller copies the control values across.
+     */
+    [[nodiscard]] virtual std::unique_ptr<ProcessorHarness> createInstance() const { return nullptr; }
     
     // =================================================================================================================================
 
@@ -69,6 +79,50 @@ public:
     [[nodiscard]] float getControlValueAsFloat (const int index) const;
 
 
+    /** Sets the time over which changes to a control are smoothed (zero, the default, applies changes at the start of the next block).
+     *  Call this from your constructor or prepare(). */
+    void setControlSmoothingTime (const int index, const double seconds);
+
+    /** Returns true if the smoothed value of a control changes during the current block (because the control was moved, is still
+     *  ramping, or the processor has been prepared or reset). Use this from process() to skip recalculating anything derived from it. */
+    [[nodiscard]] bool hasControlChanged (const int index) const;
+
+    /** Returns true if the smoothed value of any control changes during the current block. */
+    [[nodiscard]] bool hasAnyControlChanged() const;
+
+    /** Get the smoothed control value (0..1) reached by the end of the current block. Use this from process() for per-block ramps. */
+    [[nodiscard]] double getSmoothedControlValue (const int index) const;
+
+    /** Fills a buffer with the smoothed control value (0..1) for each sample of the current block. Use this from process() for
+     *  per-sample ramps. Returns false without filling the buffer if the value doesn't change during the block. */
+    bool getSmoothedControlRamp (const int index, float* destination, const int numSamples) const;
+
+    /** Call this from process() each time your processor recalculates something derived from its controls (e.g. filter coefficients),
+     *  so that the harness can report how often it happens. */
+    void countRecalculation() noexcept;
+
+    /** Returns the number of recalculations counted since statistics were reset. */
+    [[nodiscard]] double queryRecalculationCount() const;
+
+
+    /** Sets an automation lane for a control, which overrides the control value while it is active. Call this from the message thread.
+     *
+     *  Lanes are rendered into a list of events for each block, one every automation interval (if the value has changed), and the block
+     *  is split at each event so that your process() sees the new control value from exactly that sample. This works the same when
+     *  processing live and when benchmarking, so the cost of modulation (recalculation and smoothing) is included in the timings.
+     */
+    void setControlAutomation (const int index, const AutomationLane& lane);
+
+    /** Returns the automation lane for a control. Call this from the message thread. */
+    [[nodiscard]] AutomationLane getControlAutomation (const int index) const;
+
+    /** Sets the spacing of automation events in samples (which takes effect when the harness is next prepared). */
+    void setAutomationInterval (const int numSamples);
+
+    /** Returns the number of automation events delivered since statistics were reset. */
+    [[nodiscard]] double queryAutomationEventCount() const;
+
+
     [[nodiscard]] dsp::ProcessSpec getCurrentProcessSpec() const;
 
 
@@ -118,17 +172,63 @@ public:
     static int getQueryIndex (const int routineIndex, const int valueIndex);
 
 
-    /** Reset statistics */
-    void resetStatistics();
+    /** Reset statistics (override this to reset your own, but call the base class too). */
+    virtual void resetStatistics();
 
 private:
+
+    /** Smoothing and change detection for a control, which is only accessed on the processing thread. */
+    struct ControlSmoother
+    {
+        double smoothingTime = 0.0;     // Seconds
+        int rampLength = 0;             // Samples
+        double target = 0.0;
+        double start = 0.0;             // Value at the start of the current block
+        double current = 0.0;           // Value at the end of the current block
+        double step = 0.0;              // Change per sample while ramping
+        int samplesRemaining = 0;
+        int rampedSamples = 0;          // Number of samples in the current block that are part of the ramp
+        bool changed = false;
+        bool isAutomated = false;       // Use automatedValue rather than the control value
+        double automatedValue = 0.0;    // Value of the latest automation event delivered
+        double renderedValue = -1.0;    // Value of the latest automation event rendered
+    };
+
+    /** An automation event, delivered at a sample offset within the current block. */
+    struct ControlEvent
+    {
+        int sampleOffset = 0;
+        int controlIndex = 0;
+        double value = 0.0;
+    };
+
+    /** Reads the control values and advances the smoothers by a block. */
+    void updateControls (const int numSamples);
+
+    /** Renders the automation lanes into the event list for a block (in order of sample offset). */
+    void renderAutomation (const std::vector<AutomationLane>& lanes, const int numSamples);
+
+    /** Processes a block (or part of one) and returns the time taken (in milliseconds). */
+    double processAndTime (const dsp::ProcessContextReplacing<float>& context);
     	
     dsp::ProcessSpec currentSpec;
     double prepDurationMin = 1.0E100, prepDurationMax = -1.0, prepDurationSum = 0.0, prepDurationCount = 0.0;
     double procDurationMin = 1.0E100, procDurationMax = -1.0, procDurationSum = 0.0, procDurationCount = 0.0;
     double resetDurationMin = 1.0E100, resetDurationMax = -1.0, resetDurationSum = 0.0, resetDurationCount = 0.0;
 
+    double recalculationCount = 0.0;
+    double automationEventCount = 0.0;
+
     std::vector <Atomic<double>> controlValues;
+    std::vector <ControlSmoother> controlSmoothers;
+    bool controlsNeedInitialising = true;    // Jump straight to the control values (e.g. after a reset)
+
+    std::vector<AutomationLane> automationLanes;                    // Message thread copy
+    ParameterSnapshot<std::vector<AutomationLane>> automation;
+    std::vector<ControlEvent> controlEvents;                        // Allocated in prepareHarness()
+    Atomic<int> requestedAutomationInterval = 32;
+    int automationInterval = 32;
+    int64 automationPosition = 0;                                   // Samples since the harness was reset
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorHarness)
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    ProcessorPluginApi.h
+    Created: 17 Oct 2026 6:48:40pm
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+/*
+    The C interface for processors built as shared libraries, which are loaded (and reloaded whenever they are rebuilt) by
+    PluginProcessorHarness. This header deliberately has no dependencies (not even JUCE) so that a processor can be built on its own,
+    in C or C++, against nothing but this file.
+
+    A library exports a single function, dsptbGetProcessorDescriptor(), which returns a pointer to a static descriptor:
+
+        static void* create (const DsptbHost* host)                 { return new MyProcessor (host); }
+        static void destroy (void* p)                               { delete static_cast<MyProcessor*> (p); }
+        ...
+        static const DsptbProcessorDescriptor descriptor = { DSPTB_PLUGIN_API_VERSION, "My processor", 2, getControlName,
+                                                             getDefaultControlValue, create, destroy, prepare, process, reset };
+
+        DSPTB_PLUGIN_EXPORT const DsptbProcessorDescriptor* dsptbGetProcessorDescriptor (void) { return &descriptor; }
+
+    Rules:
+    -   All functions are called on one thread at a time, and never concurrently with process(). prepare() and reset() aren't
+        necessarily called on the audio thread (e.g. the host calls them on its message thread when the library is reloaded).
+    -   prepare() may allocate, process() and reset() should not.
+    -   The descriptor and every string it returns must stay valid until the library is unloaded.
+    -   Control values are in the range 0..1 and have already been smoothed/automated by the host.
+    -   The version is checked on load, and must be incremented for any change to the structs or functions below.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+ #define DSPTB_EXTERN_C extern "C"
+#else
+ #define DSPTB_EXTERN_C
+#endif
+
+#if defined (_WIN32)
+ #define DSPTB_PLUGIN_EXPORT DSPTB_EXTERN_C __declspec(dllexport)
+#else
+ #define DSPTB_PLUGIN_EXPORT DSPTB_EXTERN_C __attribute__((visibility ("default")))
+#endif
+
+#define DSPTB_PLUGIN_API_VERSION 1
+#define DSPTB_DESCRIPTOR_FUNCTION_NAME "dsptbGetProcessorDescriptor"
+
+/** Equivalent to dsp::ProcessSpec. */
+typedef struct DsptbProcessSpec
+{
+    double sampleRate;
+    uint32_t maximumBlockSize;
+    uint32_t numChannels;
+} DsptbProcessSpec;
+
+/** A block of audio to be processed in place, along with the control values for the block. */
+typedef struct DsptbProcessBlock
+{
+    float* const* channels;
+    uint32_t numChannels;
+    uint32_t numSamples;
+    const double* controlValues;        /* One per control - the smoothed value reached by the end of the block */
+    const uint8_t* controlsChanged;     /* One per control - non-zero if the value changed during the block (or after a reset) */
+} DsptbProcessBlock;
+
+/** Services the host provides to a processor instance. */
+typedef struct DsptbHost
+{
+    void* context;
+    /* Call this each time you recalculate something derived from the controls, so the benchmark can report how often it happens */
+    void (*countRecalculation) (void* context);
+} DsptbHost;
+
+/** Describes a processor and how to create and run instances of it. */
+typedef struct DsptbProcessorDescriptor
+{
+    uint32_t apiVersion;                /* DSPTB_PLUGIN_API_VERSION */
+    const char* name;
+    int32_t numControls;
+    const char* (*getControlName) (int32_t index);
+    double (*getDefaultControlValue) (int32_t index);
+
+    void* (*create) (const DsptbHost* host);
+    void (*destroy) (void* instance);
+    void (*prepare) (void* instance, const DsptbProcessSpec* spec);
+    void (*process) (void* instance, const DsptbProcessBlock* block);
+    void (*reset) (void* instance);
+} DsptbProcessorDescriptor;
+
+typedef const DsptbProcessorDescriptor* (*DsptbGetProcessorDescriptorFunction) (void);
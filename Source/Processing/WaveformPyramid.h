@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.h
+    Created: 17 Oct 2026 10:12:31am
+    Author:  Andrew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+/**
+*   Holds the most recent samples of a signal together with a pyramid of min/max/sum summaries, so that any range of the history
+*   can be summarised by visiting a handful of bins rather than every sample. Each level summarises binFactor bins of the level below
+*   and the summaries are built incrementally as samples are appended.
+*
+*   This makes it cheap to display a long capture at any zoom level: each pixel column is a range query, so a repaint costs
+*   O(pixels) regardless of how many samples are visible, and peaks are never skipped because every sample contributes to a bin.
+*
+*   This class is not thread safe - it is intended to be filled and read on the same (non-realtime) thread.
+*/
+class WaveformPyramid final
+{
+public:
+
+    /** The summary of a range of samples. */
+    struct Summary
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float mean = 0.0f;
+    };
+
+    WaveformPyramid() = default;
+    ~WaveformPyramid() = default;
+
+    /** Sets the number of samples of history to keep (rounded up to a multiple of the largest bin size) and clears the history.
+     *  This allocates, so don't call it on the audio thread. */
+    void setCapacity (const int numSamples);
+
+    /** Gets the number of samples of history kept. */
+    [[nodiscard]] int getCapacity() const noexcept;
+
+    /** Clears the history. */
+    void clear();
+
+    /** Appends samples to the history, updating the summaries of any bins which are completed. */
+    void append (const float* data, const int numSamples);
+
+    /** Gets the total number of samples appended since the last clear (positions are counted from here). */
+    [[nodiscard]] int64 getNumSamplesWritten() const noexcept;
+
+    /** Gets the position of the oldest sample still held. */
+    [[nodiscard]] int64 getOldestPosition() const noexcept;
+
+    /** Gets the sample at an absolute position (which must be held in the history). */
+    [[nodiscard]] float getSample (const int64 position) const;
+
+    /** Summarises the samples in the absolute range [start, end), which must be held in the history. The range is broken into the
+     *  largest aligned bins that fit, so a query visits at most about 2 * binFactor bins per level. */
+    [[nodiscard]] Summary getSummary (const int64 start, const int64 end) const;
+
+private:
+
+    static constexpr int binFactor = 4;     // Number of bins from the level below summarised by each bin
+    static constexpr int numLevels = 9;     // Level 0 holds samples, so the largest bin is 4^8 = 65536 samples
+
+    struct Level
+    {
+        HeapBlock<float> mins, maxs, sums;  // Not allocated for level 0
+        int size = 0;                       // Number of bins (a power of two)
+        int64 binSize = 1;                  // Number of samples per bin
+        int64 numBinsCompleted = 0;
+    };
+
+    void updateLevel (const int levelIndex);
+
+    std::vector<Level> levels;
+    HeapBlock<float> samples;               // Level 0
+    int capacity = 0;                       // Power of two
+    int64 numSamplesWritten = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformPyramid)
+};
+
+
+// ===========================================================================================
+//  Implementation
+// ===========================================================================================
+
+inline void WaveformPyramid::setCapacity (const int numSamples)
+{
+    auto largestBin = 1;
+    for (auto k = 1; k < numLevels; ++k)
+        largestBin *= binFactor;
+
+    capacity = nextPowerOfTwo (jmax (numSamples, largestBin));
+    samples.allocate (static_cast<size_t> (capacity), true);
+
+    levels.clear();
+    levels.resize (numLevels);
+    auto binSize = static_cast<int64> (1);
+    for (auto& level : levels)
+    {
+        level.binSize = binSize;
+        level.size = static_cast<int> (capacity / binSize);
+        binSize *= binFactor;
+
+        // Level 0 is read straight from the samples, so it only needs its size and bin size
+        if (level.binSize == 1)
+            continue;
+
+        level.mins.allocate (static_cast<size_t> (level.size), true);
+        level.maxs.allocate (static_cast<size_t> (level.size), true);
+        level.sums.allocate (static_cast<size_t> (level.size), true);
+    }
+    clear();
+}
+
+inline int WaveformPyramid::getCapacity() const noexcept
+{
+    return capacity;
+}
+
+inline void WaveformPyramid::clear()
+{
+    numSamplesWritten = 0;
+    for (auto& level : levels)
+        level.numBinsCompleted = 0;
+}
+
+inline void WaveformPyramid::append (const float* data, const int numSamples)
+{
+    jassert (capacity > 0); // Call setCapacity() first
+    if (capacity <= 0 || numSamples <= 0)
+        return;
+
+    // Write samples to level 0 (only the last capacity samples matter if there are more than that)
+    const auto numToWrite = jmin (numSamples, capacity);
+    const auto skipped = numSamples - numToWrite;
+    numSamplesWritten += skipped;
+
+    const auto start = static_cast<int> (numSamplesWritten & (capacity - 1));
+    const auto numBeforeWrap = jmin (numToWrite, capacity - start);
+    FloatVectorOperations::copy (samples + start, data + skipped, numBeforeWrap);
+    if (numToWrite > numBeforeWrap)
+        FloatVectorOperations::copy (samples, data + skipped + numBeforeWrap, numToWrite - numBeforeWrap);
+    numSamplesWritten += numToWrite;
+
+    for (auto k = 1; k < numLevels; ++k)
+        updateLevel (k);
+}
+
+inline void WaveformPyramid::updateLevel (const int levelIndex)
+{
+    auto& level = levels[static_cast<size_t> (levelIndex)];
+    const auto& below = levels[static_cast<size_t> (levelIndex - 1)];
+
+    // Bins before the start of the history can't be built (and would be overwritten anyway)
+    const auto numCompleted = numSamplesWritten / level.binSize;
+    auto b = jmax (level.numBinsCompleted, getOldestPosition() / level.binSize);
+    const auto levelMask = level.size - 1;
+    const auto belowMask = below.size - 1;
+
+    for (; b < numCompleted; ++b)
+    {
+        const auto first = b * binFactor;
+        auto mn = 0.0f, mx = 0.0f, sum = 0.0f;
+
+        for (auto i = 0; i < binFactor; ++i)
+        {
+            const auto index = static_cast<int> ((first + i) & belowMask);
+            float binMin, binMax, binSum;
+            if (levelIndex == 1)
+            {
+                binMin = binMax = binSum = samples[index];
+            }
+            else
+            {
+                binMin = below.mins[index];
+                binMax = below.maxs[index];
+                binSum = below.sums[index];
+            }
+            mn = i == 0 ? binMin : jmin (mn, binMin);
+            mx = i == 0 ? binMax : jmax (mx, binMax);
+            sum += binSum;
+        }
+
+        const auto index = static_cast<int> (b & levelMask);
+        level.mins[index] = mn;
+        level.maxs[index] = mx;
+        level.sums[index] = sum;
+    }
+    level.numBinsCompleted = numCompleted;
+}
+
+inline int64 WaveformPyramid::getNumSamplesWritten() const noexcept
+{
+    return numSamplesWritten;
+}
+
+inline int64 WaveformPyramid::getOldestPosition() const noexcept
+{
+    return jmax (static_cast<int64> (0), numSamplesWritten - capacity);
+}
+
+inline float WaveformPyramid::getSample (const int64 position) const
+{
+    jassert (position >= getOldestPosition() && position < numSamplesWritten);
+    return samples[static_cast<int> (position & (capacity - 1))];
+}
+
+inline WaveformPyramid::Summary WaveformPyramid::getSummary (const int64 start, const int64 end) const
+{
+    Summary summary;
+    const auto first = jmax (start, getOldestPosition());
+    const auto last = jmin (end, numSamplesWritten);
+    if (last <= first)
+        return summary;
+
+    auto sum = 0.0f;
+    auto isFirstBin = true;
+    auto position = first;
+
+    while (position < last)
+    {
+        // Use the largest bin which is aligned at this position and fits within the range
+        auto k = 0;
+        while (k + 1 < numLevels)
+        {
+            const auto nextBinSize = levels[static_cast<size_t> (k + 1)].binSize;
+            if (position % nextBinSize != 0 || position + nextBinSize > last)
+                break;
+            ++k;
+        }
+
+        float binMin, binMax, binSum;
+        if (k == 0)
+        {
+            binMin = binMax = binSum = getSample (position);
+        }
+        else
+        {
+            const auto& level = levels[static_cast<size_t> (k)];
+            const auto index = static_cast<int> ((position / level.binSize) & (level.size - 1));
+            binMin = level.mins[index];
+            binMax = level.maxs[index];
+            binSum = level.sums[index];
+        }
+
+        summary.min = isFirstBin ? binMin : jmin (summary.min, binMin);
+        summary.max = isFirstBin ? binMax : jmax (summary.max, binMax);
+        sum += binSum;
+        isFirstBin = false;
+        position += levels[static_cast<size_t> (k)].binSize;
+    }
+
+    summary.mean = sum / static_cast<float> (last - first);
+    return summary;
+}